@@ -35,6 +35,7 @@
 
 #include <mbed.h>
 #include <brain/globalsv.hpp>
+#include <utils/textparser.hpp>
 
 namespace brain
 {
@@ -42,6 +42,7 @@
 #include <brain/robotstatemachine.hpp>
 #include <periodics/resourcemonitor.hpp>
 #include <brain/globalsv.hpp>
+#include <utils/textparser.hpp>
 
 namespace brain
 {
@@ -40,6 +40,13 @@
 /* Header file for the task manager library, which  applies periodically the fun function of it's children*/
 #include <utils/taskmanager.hpp>
 
+#include <utils/textparser.hpp>
+#include <utils/textformatter.hpp>
+/* Header file for the serial transmitter */
+#include <drivers/serialtransmitter.hpp>
+/* Header file for the serial monitor, which stamps the received commands */
+#include <drivers/serialmonitor.hpp>
+
 #include <brain/globalsv.hpp>
 
 #include <chrono>
@@ -58,7 +65,7 @@ namespace brain
             /* Constructor */
             CRobotStateMachine(
                 std::chrono::milliseconds                      f_period, 
-                UnbufferedSerial&             f_serialPort, 
+                drivers::CSerialTransmitter&  f_serialPort, 
                 drivers::ISteeringCommand&    f_steeringControl,
                 drivers::ISpeedingCommand&    f_speedingControl
             );
@@ -80,27 +87,45 @@ namespace brain
             void serialCallbackAlivecommand(char const * message, char * response);
 
         private:
+            /** @brief  Commands received since the last run, they are applied together */
+            enum EPending
+            {
+                PENDING_SPEED = 0,
+                PENDING_STEER,
+                PENDING_BRAKE,
+                pending_count
+            };
+
             /* Contains the state machine, which control the lower level drivers (motor and steering) based the current state. */
             virtual void _run();
             /* reference to Serial object */
-            UnbufferedSerial&                    m_serialPort;
+            drivers::CSerialTransmitter&  m_serialPort;
             /* Steering wheel control interface */
             drivers::ISteeringCommand&    m_steeringControl;
             /* Steering wheel control interface */
             drivers::ISpeedingCommand&    m_speedingControl;
-            /* State machine state */
+            /* State machine state, the timed movement (vcd) */
             uint8_t                       m_state;
+            /* Flags of the pending commands, one bit for each EPending */
+            uint8_t                       m_pending;
 
-            uint16_t m_ticksRun;
+            /* Start of the timed movement in microseconds */
+            uint32_t m_startTime;
 
             uint16_t m_targetTime;
 
-            uint16_t m_period;
+            /* Period of the runs without timed movement in milliseconds */
+            uint16_t m_idlePeriod;
 
             int m_speed;
             int m_steering;
 
             bool m_calibON;
+
+            /* Stamp of the pending commands, echoed after the actuation */
+            drivers::CSerialMonitor::SRequestStamp m_requests[pending_count];
+            /* Value confirmed by the response of the pending commands, the brake confirms always 1 */
+            int m_replies[pending_count];
         
     }; // class CRobotStateMachine
 }; // namespace brain
@@ -593,6 +593,17 @@ struct bno055_gravity_t
     s16 y; /**< Gravity y data */
     s16 z; /**< Gravity z data */
 };
+
+/*!
+ * @brief struct for the fusion data block read from registers 0x1A to 0x33
+ */
+struct bno055_fusion_t
+{
+    struct bno055_euler_t euler; /**< Euler hrp data */
+    struct bno055_quaternion_t quaternion; /**< Quaternion wxyz data */
+    struct bno055_linear_accel_t linear_accel; /**< Linear Accel xyz data */
+    struct bno055_gravity_t gravity; /**< Gravity xyz data */
+};
 #ifdef  BNO055_DOUBLE_ENABLE
 
 /*!
@@ -1038,6 +1049,7 @@ struct bno055_sic_matrix_t
 #define BNO055_QUATERNION_WXYZ_DATA_SIZE           (8)
 #define BNO055_GRAVITY_DATA_SIZE                   (2)
 #define BNO055_GRAVITY_XYZ_DATA_SIZE               (6)
+#define BNO055_FUSION_DATA_SIZE                    (26)
 #define BNO055_ACCEL_OFFSET_ARRAY                  (6)
 #define BNO055_MAG_OFFSET_ARRAY                    (6)
 #define BNO055_GYRO_OFFSET_ARRAY                   (6)
@@ -2916,6 +2928,17 @@ BNO055_RETURN_FUNCTION_TYPE bno055_read_gravity_z(s16 *gravity_z_s16);
  */
 BNO055_RETURN_FUNCTION_TYPE bno055_read_gravity_xyz(struct bno055_gravity_t *gravity);
 
+/*!
+ *  @brief This API decodes the fusion data block read from
+ *  register 0x1A to 0x33 (e.g. by an asynchronous bus read)
+ *
+ *
+ *  @param data_u8 : The twenty six bytes of the block
+ *  @param fusion : The value of the fusion data's
+ *
+ */
+void bno055_decode_fusion_data(const u8 *data_u8, struct bno055_fusion_t *fusion);
+
 /**************************************************/
 /**\name TEMPERATURE DATA READ FUNCTIONS */
 /**************************************************/
@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+/* Include guard */
+#ifndef BNO055_SHADOW_HPP
+#define BNO055_SHADOW_HPP
+
+#include <stdint.h>
+/* The BNO055 driver, the types and the register map */
+#include <drivers/bno055.hpp>
+
+#define bno055_shadow_pages 2
+#define bno055_shadow_registers 128
+
+namespace drivers
+{
+   /**
+    * @brief Class BNO055 register shadow
+    * 
+    * It's placed between the BNO055 driver and the bus functions, it keeps a copy of the page register and of the configuration 
+    * registers. The driver selects the page before each access and reads back a configuration register before each write, 
+    * these accesses are served from the copy, and the writes of an unchanged value are skipped. The data registers are 
+    * always accessed on the bus.
+    * 
+    * The configuration registers of the page zero (units, power mode, operation mode, temperature source, axis remap) are 
+    * changed only by the host. The registers of the page one (sensor configurations and interrupts) are changed by the 
+    * sensor in the fusion modes, so they are kept only while the sensor is in config mode. The copy is dropped after a 
+    * failed access, a system reset and by invalidate.
+    * 
+    * The bus functions are static, as the driver takes function pointers, so there is only one shadowed sensor.
+    */
+    class CBno055Shadow
+    {
+        public:
+            /** @brief Bus function of the driver */
+            typedef s8 (*FBus)(u8 dev_addr, u8 reg_addr, u8 *reg_data, u8 cnt);
+
+            /** @brief Statistics of the accesses */
+            struct SStats
+            {
+                /** @brief  number of the reads made on the bus */
+                uint32_t reads;
+                /** @brief  number of the writes made on the bus */
+                uint32_t writes;
+                /** @brief  number of the reads served from the copy */
+                uint32_t cachedReads;
+                /** @brief  number of the skipped writes */
+                uint32_t skippedWrites;
+            };
+
+            /* Sets the functions accessing the bus and drops the copy */
+            static void attach(FBus f_write, FBus f_read);
+            /* Bus write function for the driver */
+            static s8 busWrite(u8 dev_addr, u8 reg_addr, u8 *reg_data, u8 cnt);
+            /* Bus read function for the driver */
+            static s8 busRead(u8 dev_addr, u8 reg_addr, u8 *reg_data, u8 cnt);
+            /* Drops the copy of the registers */
+            static void invalidate();
+            /** @brief  Statistics of the accesses */
+            static const SStats& getStats()
+            {
+                return s_stats;
+            }
+            /* Clears the statistics */
+            static void resetStats();
+        private:
+            /* The register is kept in the copy */
+            static bool isShadowed(u8 f_register);
+            /* The sensor is in config mode */
+            static bool isConfigMode();
+            /* Drops the copy of the registers of a page */
+            static void invalidatePage(u8 f_page);
+            /* Drops the copy of a register */
+            static void invalidateRegister(u8 f_page, u8 f_register);
+
+            /** @brief Function writing on the bus */
+            static FBus s_write;
+            /** @brief Function reading from the bus */
+            static FBus s_read;
+            /** @brief Selected page */
+            static u8 s_page;
+            /** @brief The selected page is known */
+            static bool s_pageValid;
+            /** @brief Copy of the registers */
+            static u8 s_values[bno055_shadow_pages][bno055_shadow_registers];
+            /** @brief Valid registers of the copy, one bit for each register */
+            static uint32_t s_valid[bno055_shadow_pages][bno055_shadow_registers / 32];
+            /** @brief Statistics */
+            static SStats s_stats;
+    }; // class CBno055Shadow
+}; // namespace drivers
+
+#endif // BNO055_SHADOW_HPP
\ No newline at end of file
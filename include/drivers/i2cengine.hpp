@@ -0,0 +1,154 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+/* Include guard */
+#ifndef I2C_ENGINE_HPP
+#define I2C_ENGINE_HPP
+
+/* The mbed library */
+#include <mbed.h>
+/* Header file for the lock-free ring buffer */
+#include <utils/ringbuffer.hpp>
+
+// The transactions are made in background by the interrupt driven transfer of mbed on the targets supporting it
+#if defined(DEVICE_I2C_ASYNCH) && DEVICE_I2C_ASYNCH
+#define I2C_ENGINE_ASYNCH 1
+#else
+#define I2C_ENGINE_ASYNCH 0
+#endif
+
+#define i2c_queue_size 4 // power of two
+#define i2c_max_tx 8
+
+namespace drivers
+{
+   /**
+    * @brief Class I2C Engine
+    * 
+    * It makes the I2C transactions (a write followed by a read with repeated start) in background, so the task using the bus 
+    * doesn't wait for the bus. The transactions are queued by submit and made one after another by the interrupt driven transfer 
+    * of the I2C peripheral. The interrupt only marks the completion and applies the wakeup callback (e.g. the notification of 
+    * the task), the completion callback of the transaction is applied from task context by the process method, which starts the 
+    * next queued transaction too. A transaction without completion in i2c_timeout_us is aborted and completed with error.
+    * 
+    * The latency of the transactions (from the submit to the completion, queueing and bus time) is measured in microseconds.
+    * On the targets without asynchronous I2C the transactions are made blocking in submit.
+    */
+    class CI2CEngine
+    {
+        public:
+            /** @brief Completion callback, the parameter is zero for success, negative for error */
+            typedef mbed::Callback<void(int)> FDone;
+
+            /** @brief Statistics of the transactions */
+            struct SStats
+            {
+                /** @brief  number of completed transactions */
+                uint32_t count;
+                /** @brief  number of failed or aborted transactions */
+                uint32_t errors;
+                /** @brief  latency of the last transaction in microseconds */
+                uint32_t latencyLast;
+                /** @brief  maximum latency in microseconds */
+                uint32_t latencyMax;
+                /** @brief  sum of the latencies in microseconds */
+                uint64_t latencySum;
+            };
+
+            /* Constructor */
+            CI2CEngine(
+                PinName f_sda,
+                PinName f_scl,
+                uint32_t f_frequency,
+                mbed::Callback<void()> f_wakeup
+            );
+            /* Destructor */
+            ~CI2CEngine();
+            /** @brief  The bus, for the blocking accesses while the engine is idle */
+            I2C& getBus()
+            {
+                return m_bus;
+            }
+            /* Queues a transaction */
+            bool submit(uint8_t f_address, const uint8_t* f_tx, uint8_t f_txLength, uint8_t* f_rx, uint8_t f_rxLength, FDone f_done);
+            /* Completes the finished transaction and starts the next one, task context */
+            bool process();
+            /** @brief  There is no transaction in progress or queued */
+            bool isIdle()
+            {
+                return !m_busy && m_queue.isEmpty();
+            }
+            /** @brief  Statistics of the transactions */
+            const SStats& getStats()
+            {
+                return m_stats;
+            }
+            /* Clears the statistics */
+            void resetStats();
+        private:
+            /** @brief Queued transaction */
+            struct STransaction
+            {
+                uint8_t address;
+                uint8_t tx[i2c_max_tx];
+                uint8_t txLength;
+                uint8_t* rx;
+                uint8_t rxLength;
+                FDone done;
+                uint32_t submitTime;
+            };
+
+            /* Starts the first queued transaction */
+            void start();
+            /* Completes the transaction in progress */
+            void finish(int f_result);
+            /* Transfer callback, interrupt context */
+            void transferCallback(int f_event);
+
+            /** @brief I2C peripheral */
+            I2C m_bus;
+            /** @brief Applied from interrupt context at the completion */
+            mbed::Callback<void()> m_wakeup;
+            /** @brief Queued transactions, the first one is in progress */
+            utils::CRingBuffer<STransaction, i2c_queue_size> m_queue;
+            /** @brief A transaction is in progress */
+            bool m_busy;
+            /** @brief The transaction in progress completed, set from interrupt context */
+            volatile bool m_completed;
+            /** @brief Events of the completed transfer */
+            volatile int m_event;
+            /** @brief Start time of the transaction in progress in microseconds */
+            uint32_t m_startTime;
+            /** @brief Statistics */
+            SStats m_stats;
+    }; // class CI2CEngine
+}; // namespace drivers
+
+#endif // I2C_ENGINE_HPP
\ No newline at end of file
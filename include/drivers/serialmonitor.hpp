@@ -36,15 +36,19 @@
 #include <mbed.h>
 /* Header file for the task manager library, which  applies periodically the fun function of it's children*/
 #include <utils/taskmanager.hpp>
-/* Header file for the queue manager library*/
-#include <utils/queue.hpp>
 
-#include <map>
+#include <utils/textparser.hpp>
+#include <utils/textformatter.hpp>
+/* Header file for the serial receiver */
+#include <drivers/serialreceiver.hpp>
+/* Header file for the serial transmitter */
+#include <drivers/serialtransmitter.hpp>
+
 #include <array>
-#include <string>
-#include <functional>
 #include <chrono>
 
+#define subscriber_table_size 64 // power of two, at least two times the number of subscribers
+
 
 namespace drivers
 {
@@ -61,40 +65,176 @@ namespace drivers
     *   "@KEY1:RESPONSECONTANT;;\r\n"
     * 
     * The key differs for each functionalities, so for each callback function.
+    * 
+    * In binary mode (selected by the "binary" command) the messages are COBS frames, see utils::CBinaryFrame. The identifier of the frame 
+    * selects the subscriber, the payload is the content of the message and the response is sent in a frame with the same identifier.
+    * The subscribers are given in a constant array, the keys are indexed by an open addressing hash table (FNV-1a hash, linear probing) 
+    * built in the constructor, so the key of a message is found in constant time without heap allocation.
+    * 
+    * The baud rate is negotiated with the "#baud:RATE;;" command: the response is sent at the old rate, the port is switched after 
+    * the response was transmitted, then the other device has to send a message (e.g. "#alive:0;;") at the new rate within 
+    * one second. Without a valid message the old rate is restored and "@baud:OLD_RATE;;" is sent.
+    * 
+    * The key of a text message can be extended with a sequence number, "#KEY/SEQ:CONTENT;;\r\n". The response of such request 
+    * echoes the sequence number and adds the board timestamps in microseconds of the reception, of the dispatch and of the 
+    * response (or of the actuation, for the commands applied later by their task):
+    * 
+    *   "@KEY/SEQ/T_RX/T_DISPATCH/T_DONE:RESPONSECONTENT;;\r\n"
+    * 
+    * A text message can carry several commands separated by '|', they are applied in order in the same run and their responses 
+    * are coalesced into one line (the commands without response are skipped). The message is dropped, if a command is malformed 
+    * or has an unknown key, but the contents are checked only by the callbacks, one after the other:
+    * 
+    *   "#KEY1:CONTENT1;;|KEY2:CONTENT2;;\r\n"
+    * 
+    *   "@KEY1:RESPONSE1;;|KEY2:RESPONSE2;;\r\n"
     */
     class CSerialMonitor : public utils::CTask
     {
         public:
             typedef mbed::Callback<void(char const *, char *)> FCallback;
-            typedef std::map<string,FCallback> CSerialSubscriberMap;
+
+            /** @brief Subscriber of the messages with the given key */
+            struct SSubscriber
+            {
+                /** @brief key of the messages */
+                const char* key;
+                /** @brief callback function applied with the content of the messages */
+                FCallback callback;
+                /** @brief identifier of the binary frames (CSerialTransmitter::EFrameId), ID_TEXT if it isn't available in binary mode */
+                uint8_t id;
+            };
+
+            /** @brief Sequence number and timestamps of a request, the sequence number is available only with extended key */
+            struct SRequestStamp
+            {
+                /** @brief the request has a sequence number, the times are stamped for all requests */
+                bool valid;
+                /** @brief sequence number of the request */
+                uint32_t sequence;
+                /** @brief time of the reception in microseconds */
+                uint32_t rxTime;
+                /** @brief time of the dispatch in microseconds */
+                uint32_t dispatchTime;
+            };
+
+            /* Hash of the key, it ends at the null or the ':' character */
+            static constexpr uint32_t hashKey(const char* f_key)
+            {
+                uint32_t l_hash = 2166136261u; // FNV-1a offset basis
+                while ((*f_key != '\0') && (*f_key != ':'))
+                {
+                    l_hash = (l_hash ^ (uint8_t)*f_key++) * 16777619u; // FNV-1a prime
+                }
+                return l_hash;
+            }
+
+            /** @brief  State of the baud rate negotiation */
+            enum EBaudState
+            {
+                /** @brief  no negotiation */
+                BAUD_IDLE,
+                /** @brief  waiting the transmission of the response at the old rate */
+                BAUD_DRAINING,
+                /** @brief  waiting the last character leaving the shift register */
+                BAUD_SETTLING,
+                /** @brief  switched, waiting a valid message at the new rate */
+                BAUD_VERIFYING
+            };
 
             /* Constructor */
             CSerialMonitor(
                 UnbufferedSerial& f_serialPort,
-                CSerialSubscriberMap f_serialSubscriberMap
+                CSerialTransmitter& f_serialTx,
+                const SSubscriber* f_subscribers,
+                uint8_t f_subscriberCount,
+                uint32_t f_baudRate
             );
             /* Destructor */
             ~CSerialMonitor();
+            /* Serial callback for selecting the binary mode */
+            void serialCallbackBINARYcommand(char const * a, char * b);
+            /* Serial callback for changing the baud rate */
+            void serialCallbackBAUDcommand(char const * a, char * b);
+            /** @brief  Receiver of the characters, for its statistics */
+            CSerialReceiver& getReceiver()
+            {
+                return m_receiver;
+            }
+            /** @brief  Stamp of the request under dispatch, it's valid only in the callback functions */
+            static const SRequestStamp& currentRequest()
+            {
+                return s_request;
+            }
+            /** @brief  Appends the extension "/SEQ/T_RX/T_DISPATCH/T_DONE" of the key, if the request has a sequence number */
+            static void appendStamp(utils::CTextFormatter& f_text, const SRequestStamp& f_request, uint32_t f_doneTime)
+            {
+                if (!f_request.valid) return;
+                f_text.appendChar('/').appendUnsigned(f_request.sequence).appendChar('/').appendUnsigned(f_request.rxTime)
+                      .appendChar('/').appendUnsigned(f_request.dispatchTime).appendChar('/').appendUnsigned(f_doneTime);
+            }
         private:
             /* Rx callback actions */
             void serialRxCallback();
-            /* Tx callback actions */
-            void serialTxCallback();
             /* Run method */
             virtual void _run();
+            /* Parsing of a received character */
+            void parseChar(char f_c);
+            /* Parsing of a received character in text mode */
+            void parseText(char f_c);
+            /* Parsing of a received byte in binary mode */
+            void parseBinary(char f_c);
+            /* Dispatching of a complete message */
+            void dispatch();
+            /* Dispatching of a complete binary frame */
+            void dispatchBinary(uint32_t f_length);
+            /* Search of the subscriber with the key */
+            const SSubscriber* findSubscriber(const char* f_key);
+            /* Timer callback of the baud rate negotiation */
+            void baudTimerCallback();
+            /* Steps of the baud rate negotiation */
+            void updateBaudRate();
+            /* Applies the baud rate on the port */
+            void applyBaudRate(uint32_t f_baudRate);
+            /* Restarts the timer of the baud rate negotiation */
+            void startBaudTimer(std::chrono::microseconds f_delay);
 
-            /** @brief Serial communication port */
-            UnbufferedSerial& m_serialPort;
-            /** @brief Rx buffer */
-            utils::CQueue<char,255> m_RxBuffer;
-            /** @brief Tx buffer */
-            utils::CQueue<char,255> m_TxBuffer;
+            /** @brief Receiver of the characters */
+            CSerialReceiver m_receiver;
+            /** @brief Transmitter of the responses */
+            CSerialTransmitter& m_serialTx;
             /** @brief Data buffer */
             array<char,256> m_parseBuffer;
             /** @brief Parse iterator */
             array<char,256>::iterator m_parseIt;
-            /** @brief Serial subscriber */
-            CSerialSubscriberMap m_serialSubscriberMap;
+            /** @brief Serial subscribers */
+            const SSubscriber* m_subscribers;
+            /** @brief Hash table with the index of the subscribers, empty_slot for the free positions */
+            uint8_t m_subscriberTable[subscriber_table_size];
+            /** @brief Index of the subscribers by the identifier of the binary frames */
+            uint8_t m_idTable[subscriber_table_size];
+            /** @brief Requested mode, applied after the response was sent (-1 none, 0 text, 1 binary) */
+            int8_t m_modeRequest;
+            /** @brief Serial communication port */
+            UnbufferedSerial& m_serialPort;
+            /** @brief Current baud rate */
+            uint32_t m_baudRate;
+            /** @brief Baud rate restored, when the new one isn't verified */
+            uint32_t m_baudFallback;
+            /** @brief Requested baud rate */
+            uint32_t m_baudRequest;
+            /** @brief State of the baud rate negotiation */
+            EBaudState m_baudState;
+            /** @brief The timer of the negotiation expired */
+            volatile bool m_baudTimerExpired;
+            /** @brief Timer of the baud rate negotiation */
+            Timeout m_baudTimer;
+            /** @brief Time of the last reception interrupt in microseconds */
+            volatile uint32_t m_rxTime;
+            /** @brief Time of the reception of the message under parsing */
+            uint32_t m_messageRxTime;
+            /** @brief Stamp of the request under dispatch */
+            static SRequestStamp s_request;
     }; // class CSerialMonitor
 
 }; // namespace drivers
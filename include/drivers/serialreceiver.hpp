@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+/* Include guard */
+#ifndef SERIAL_RECEIVER_HPP
+#define SERIAL_RECEIVER_HPP
+
+/* The mbed library */
+#include <mbed.h>
+/* Header file for the lock-free ring buffer */
+#include <utils/ringbuffer.hpp>
+
+// On the STM32F4 targets the reception of the USART2 (USBTX/USBRX) is made by a circular DMA buffer
+#if defined(TARGET_STM32F4)
+#define SERIAL_RECEIVER_DMA 1
+#else
+#define SERIAL_RECEIVER_DMA 0
+#endif
+
+#define rx_buffer_size 512
+
+namespace drivers
+{
+   /**
+    * @brief Class Serial Receiver
+    * 
+    * It receives the characters of the serial port into a buffer, from which the consumer reads them in chunks. 
+    * On the STM32F4 targets the characters are written by the DMA into a circular buffer, there is no interrupt for each character. 
+    * The callback is applied from interrupt context, when the line became idle after a reception and when the DMA reached the half 
+    * and the end of the buffer. On the other targets the characters are read one by one in the receive interrupt of the serial port 
+    * into a ring buffer, and the callback is applied at each interrupt. The chunks can be injected in this case (e.g. on host).
+    * 
+    * The buffer has to be read faster, than it's filled, the DMA overwrites the unread characters. The lost characters are 
+    * counted: with the DMA by comparing the laps of the DMA (counted at the half and the end of the buffer) with the consumed 
+    * characters, otherwise the characters received into the full buffer. The line errors of the USART (overrun, noise, framing 
+    * and parity) are counted too, they are available only with the DMA.
+    */
+    class CSerialReceiver
+    {
+        public:
+            /* Constructor */
+            CSerialReceiver(
+                UnbufferedSerial& f_serialPort,
+                mbed::Callback<void()> f_callback
+            );
+            /* Destructor */
+            ~CSerialReceiver();
+            /* Contiguous received characters */
+            uint32_t peek(const char*& f_chars);
+            /* Removes the peeked characters */
+            void consume(uint32_t f_len);
+            /* Is empty method */
+            bool isEmpty();
+            /** @brief  Number of the characters lost, because the buffer was full */
+            uint32_t getOverflows()
+            {
+                return m_overflows;
+            }
+            /** @brief  Number of the line errors */
+            uint32_t getErrors()
+            {
+                return m_errors;
+            }
+#if !SERIAL_RECEIVER_DMA
+            /* Injects received characters */
+            uint32_t inject(const char* f_chars, uint32_t f_len);
+#endif
+        private:
+#if SERIAL_RECEIVER_DMA
+            /* Position of the DMA in the buffer */
+            inline uint32_t getHead();
+            /* DMA interrupt handler */
+            static void dmaIrqHandler();
+            /* Serial interrupt handler */
+            static void uartIrqHandler();
+
+            /** @brief Receiver served by the interrupt handlers */
+            static CSerialReceiver* s_instance;
+            /** @brief Previous serial interrupt handler */
+            static uint32_t s_uartVector;
+            /** @brief Circular buffer written by the DMA */
+            char m_buffer[rx_buffer_size];
+            /** @brief Read position in the buffer */
+            uint32_t m_tail;
+            /** @brief Number of the characters written by the DMA until the last half of the buffer, modified by the interrupt */
+            volatile uint32_t m_written;
+            /** @brief Number of the consumed characters, modified by the consumer */
+            volatile uint32_t m_read;
+#else
+            /* Rx callback actions */
+            void serialRxCallback();
+
+            /** @brief Ring buffer filled by the receive interrupt */
+            utils::CRingBuffer<char,rx_buffer_size> m_buffer;
+#endif
+            /** @brief Serial communication port */
+            UnbufferedSerial& m_serialPort;
+            /** @brief Callback applied after the reception */
+            mbed::Callback<void()> m_callback;
+            /** @brief Number of the lost characters, modified by the interrupt */
+            volatile uint32_t m_overflows;
+            /** @brief Number of the line errors, modified by the interrupt */
+            volatile uint32_t m_errors;
+    }; // class CSerialReceiver
+
+}; // namespace drivers
+
+#endif // SERIAL_RECEIVER_HPP
\ No newline at end of file
@@ -0,0 +1,212 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+/* Include guard */
+#ifndef SERIAL_TRANSMITTER_HPP
+#define SERIAL_TRANSMITTER_HPP
+
+/* The mbed library */
+#include <mbed.h>
+/* Header file for the lock-free ring buffer */
+#include <utils/ringbuffer.hpp>
+/* Header file for the binary frames */
+#include <utils/binaryframe.hpp>
+
+// On the STM32F4 targets the transmission of the USART2 (USBTX/USBRX) is made by DMA
+#if defined(TARGET_STM32F4)
+#define SERIAL_TRANSMITTER_DMA 1
+#else
+#define SERIAL_TRANSMITTER_DMA 0
+#endif
+
+#define tx_buffer_size 1024
+// Free space of the queue reserved for the responses, the telemetry messages aren't queued into it
+#define tx_telemetry_reserve (tx_buffer_size / 4)
+
+namespace drivers
+{
+   /**
+    * @brief Class Serial Transmitter
+    * 
+    * It aims to send the messages of the tasks without blocking them for the transmission time. The write method copies the message 
+    * into a queue and returns immediately, the queue is transmitted in background. On the STM32F4 targets the contiguous parts of 
+    * the queue are sent by DMA, on the other targets the characters are written one by one in the transmit interrupt of the serial 
+    * port, which is attached only while the queue isn't empty. The messages, which don't fit into the queue, are dropped entirely.
+    * 
+    * In binary mode the messages are sent in COBS frames (see utils::CBinaryFrame). The tasks with binary payload send their 
+    * frames with writeFrame, the text messages given to the write method are sent in frames with the ID_TEXT identifier.
+    * 
+    * The write methods can be applied only from the main thread, the queue has a single producer.
+    * 
+    * The queued characters are counted for each source (frame identifier) over windows of one second, the load of the link is 
+    * the number of the queued characters relative to the characters transmittable in one second at the baud rate. The messages 
+    * have a priority: the telemetry messages aren't queued into the last tx_telemetry_reserve characters of the queue, the 
+    * space is kept for the responses of the commands. The link is congested, when the load reached congestion_load or 
+    * telemetry messages were rejected in the last window, the telemetry producers are expected to slow down meanwhile.
+    */
+    class CSerialTransmitter
+    {
+        public:
+            /** @brief  Identifiers of the binary frames, a command and its messages have the same identifier, the commands 
+             * with the ID_TEXT identifier aren't available in binary mode */
+            enum EFrameId
+            {
+                ID_TEXT = 0x00,
+                ID_SPEED,
+                ID_STEER,
+                ID_BRAKE,
+                ID_VCD,
+                ID_VCD_CALIB,
+                ID_STEER_LIMITS,
+                ID_ALIVE,
+                ID_BATTERY,
+                ID_INSTANT,
+                ID_IMU,
+                ID_KL,
+                ID_BATTERY_CAPACITY,
+                ID_RESOURCE_MONITOR,
+                ID_TASK_STATS,
+                ID_BINARY,
+                ID_TELEMETRY,
+                ID_SUBSCRIBE,
+                ID_BANDWIDTH,
+                ID_BAUD,
+                ID_SYNC,
+                ID_CLOCK,
+                ID_IMU_STREAM,
+                ID_I2C,
+                ID_IMU_QUAT,
+                id_count
+            };
+
+            /** @brief  Priority of the messages */
+            enum EPriority
+            {
+                /** @brief  responses of the commands and events, they can use the whole queue */
+                PRIORITY_RESPONSE = 0,
+                /** @brief  periodic messages, they are rejected before the queue is full */
+                PRIORITY_TELEMETRY
+            };
+
+            /** @brief  Load of the link (in hundredths of percent), from which the link is congested */
+            static const uint16_t congestion_load = 8000;
+
+            /* Constructor */
+            CSerialTransmitter(
+                UnbufferedSerial& f_serialPort,
+                uint32_t f_baudRate
+            );
+            /* Destructor */
+            ~CSerialTransmitter();
+            /* Queues a message for transmission */
+            ssize_t write(const void* f_buffer, std::size_t f_length, uint8_t f_source = ID_TEXT, EPriority f_priority = PRIORITY_RESPONSE);
+            /* Queues a binary frame for transmission */
+            ssize_t writeFrame(uint8_t f_id, const void* f_payload, std::size_t f_length, EPriority f_priority = PRIORITY_RESPONSE);
+            /* Selects the binary or the text mode */
+            void setBinaryMode(bool f_binary);
+            /* Binary mode is selected */
+            bool isBinaryMode();
+            /* Number of the queued characters */
+            uint32_t getQueueDepth();
+            /* Maximum number of the queued characters */
+            uint32_t getQueueMax();
+            /* Restarts the measurement of the maximum number of the queued characters */
+            void resetQueueMax();
+            /* Number of the dropped characters */
+            uint32_t getDropped();
+            /* Number of the telemetry characters rejected for the responses */
+            uint32_t getRejected();
+            /* Characters per second queued by the source in the last window */
+            uint32_t getRate(uint8_t f_source);
+            /* Load of the link in the last window */
+            uint16_t getLoad();
+            /* The link is congested */
+            bool isCongested();
+            /* Set the baud rate used for the measurement of the load */
+            void setBaudRate(uint32_t f_baudRate);
+            /* The queue is empty and no transmission is in progress */
+            bool isIdle();
+        private:
+            /* Encodes and queues a binary frame */
+            ssize_t queueFrame(uint8_t f_id, const void* f_payload, std::size_t f_length, uint8_t f_source, EPriority f_priority);
+            /* Copies the characters into the queue */
+            ssize_t queue(const void* f_buffer, std::size_t f_length, uint8_t f_source, EPriority f_priority);
+            /* Closes the measurement window, when it elapsed */
+            void updateWindow();
+            /* Starts the transmission of the queue */
+            void startTransmission();
+#if SERIAL_TRANSMITTER_DMA
+            /* DMA interrupt handler */
+            static void dmaIrqHandler();
+
+            /** @brief Transmitter served by the interrupt handler */
+            static CSerialTransmitter* s_instance;
+            /** @brief Number of the characters under transmission by the DMA */
+            volatile uint32_t m_chunk;
+            /** @brief Number of the characters lost by transfer errors of the DMA, it's modified only by the interrupt */
+            volatile uint32_t m_dmaDropped;
+#else
+            /* Tx callback actions */
+            void serialTxCallback();
+            
+            /** @brief The transmit interrupt is attached */
+            volatile bool m_active;
+#endif
+            /** @brief Serial communication port */
+            UnbufferedSerial& m_serialPort;
+            /** @brief Queue of the characters */
+            utils::CRingBuffer<char,tx_buffer_size> m_buffer;
+            /** @brief Maximum number of the queued characters */
+            uint32_t m_queueMax;
+            /** @brief Number of the dropped characters */
+            uint32_t m_dropped;
+            /** @brief Binary mode */
+            bool m_binaryMode;
+            /** @brief Number of the characters transmittable in one second */
+            uint32_t m_linkCapacity;
+            /** @brief Number of the rejected telemetry characters */
+            uint32_t m_rejected;
+            /** @brief Start of the measurement window in milliseconds */
+            uint32_t m_windowStart;
+            /** @brief Characters queued by the sources in the current window */
+            uint32_t m_windowChars[id_count];
+            /** @brief Characters queued by the sources in the last window */
+            uint32_t m_rates[id_count];
+            /** @brief Rejected characters in the current window */
+            uint32_t m_windowRejected;
+            /** @brief Load of the link in the last window, in hundredths of percent */
+            uint16_t m_load;
+            /** @brief Telemetry characters were rejected in the last window */
+            bool m_rejectedLast;
+    }; // class CSerialTransmitter
+
+}; // namespace drivers
+
+#endif // SERIAL_TRANSMITTER_HPP
\ No newline at end of file
@@ -48,6 +48,10 @@
 #include <periodics/resourcemonitor.hpp>
 /* Header file for the powermanager functionality */
 #include <periodics/powermanager.hpp>
+/* Header file for the clock synchronisation functionality */
+#include <periodics/clocksync.hpp>
+/* Header file for the telemetry functionality */
+#include <periodics/telemetry.hpp>
 /* Header file for global variables */
 #include <brain/globalsv.hpp>
 /* Header file for the battery manager functionality */
@@ -60,3 +64,5 @@
 #include <utils/taskmanager.hpp>
 /* Header file for the task manager library, which  applies periodically the fun function of it's children*/
 #include <utils/task.hpp>
+/* Header file for the formatting of the text messages without the printf family */
+#include <utils/textformatter.hpp>
@@ -5,6 +5,7 @@
 #include <mbed.h>
 #include <chrono>
 #include <utils/task.hpp>
+#include <utils/textparser.hpp>
 
 namespace periodics
 {
@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+/* Include guard */
+#ifndef CLOCKSYNC_HPP
+#define CLOCKSYNC_HPP
+
+/* The mbed library */
+#include <mbed.h>
+/* Header file for the task manager library, which  applies periodically the fun function of it's children*/
+#include <utils/task.hpp>
+#include <utils/textparser.hpp>
+#include <utils/textformatter.hpp>
+#include <drivers/serialtransmitter.hpp>
+#include <drivers/serialmonitor.hpp>
+#include <chrono>
+
+namespace periodics
+{
+   /**
+    * @brief It aims to estimate the offset and the drift of the board's microsecond clock to the host's clock with NTP-like exchanges, 
+    * so the telemetry can be stamped with host time. The host starts the polling with the "#sync:PERIOD;;" command (PERIOD in 
+    * milliseconds, zero stops). At each period the board sends its time T1 in "@sync:T1;;\r\n", the host answers with 
+    * "#sync:T1;T2;T3;;", where T2 is the reception time of the poll and T3 is the sending time of the answer on the host clock. 
+    * The board takes the reception time T4 of the answer in the receiver's interrupt. All times are in microseconds, modulo 2^32.
+    * 
+    * The offset of the exchange is ((T2 - T1) + (T3 - T4)) / 2 and its round trip delay is (T4 - T1) - (T3 - T2). The exchanges, 
+    * which were delayed much more than the fastest recent exchange, are dropped (the offset error can reach the half of the delay). 
+    * The accepted offsets drive a phase and frequency locked loop: the offset is corrected with the quarter of the prediction error, 
+    * the drift with the sixteenth of the error divided by the time since the previous exchange. The quality of the synchronisation 
+    * is the mean absolute prediction error, the clock is synchronised after sync_min_samples exchanges with a quality better than 
+    * sync_max_quality_us. The "#clock:0;;" command reports "SYNCED;OFFSET;DRIFT;DELAY;QUALITY", the offset, the minimum delay 
+    * and the quality in microseconds, the drift in parts per billion.
+    */
+    class CClockSync : public utils::CTask
+    {
+        public:
+            /** @brief  Number of the accepted exchanges before the clock is synchronised */
+            static const uint8_t sync_min_samples = 4;
+
+            /** @brief  Maximum mean absolute error of the synchronised clock in microseconds */
+            static const uint32_t sync_max_quality_us = 1000;
+
+            /* Constructor */
+            CClockSync(
+                std::chrono::milliseconds f_period,
+                drivers::CSerialTransmitter& f_serial
+            );
+            /* Destructor */
+            ~CClockSync();
+            /* Serial callback implementation */
+            void serialCallbackSYNCcommand(char const * a, char * b);
+            /* Serial callback implementation */
+            void serialCallbackCLOCKcommand(char const * a, char * b);
+            /* Maps the board time to host time */
+            bool toHost(uint32_t f_boardTime, uint32_t& f_hostTime);
+            /** @brief  The clock is synchronised with the required quality */
+            bool isSynced()
+            {
+                return (m_samples >= sync_min_samples) && (m_quality < sync_max_quality_us);
+            }
+        private:
+            /* Run method */
+            virtual void _run();
+            /* Updates the estimation with an exchange */
+            void update(uint32_t f_t1, uint32_t f_t2, uint32_t f_t3, uint32_t f_t4);
+
+            /** @brief Serial communication obj. */
+            drivers::CSerialTransmitter& m_serial;
+            /** @brief Period of the task in milliseconds */
+            uint32_t m_basePeriod;
+            /** @brief Period of the polls in cycles of the task, zero stops the polling */
+            uint16_t m_pollCycles;
+            /** @brief Cycles until the next poll */
+            uint16_t m_pollCounter;
+            /** @brief The poll waits for its answer */
+            bool m_pollPending;
+            /** @brief Board time of the last poll (T1) */
+            uint32_t m_pollTime;
+            /** @brief Number of the accepted exchanges since the (re)start of the estimation */
+            uint32_t m_samples;
+            /** @brief Board time of the last accepted exchange, the reference of the drift */
+            uint32_t m_refTime;
+            /** @brief Offset of the host clock at the reference time */
+            uint32_t m_refOffset;
+            /** @brief Drift of the host clock in parts per billion */
+            int32_t m_drift;
+            /** @brief Minimum round trip delay of the recent exchanges in microseconds */
+            uint32_t m_minDelay;
+            /** @brief Mean absolute prediction error in microseconds */
+            uint32_t m_quality;
+    }; // class CClockSync
+}; // namespace periodics
+
+#endif // CLOCKSYNC_HPP
\ No newline at end of file
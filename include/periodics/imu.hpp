@@ -34,20 +34,86 @@
 #define BNO055_I2C_BUS_WRITE_ARRAY_INDEX ((u8)1)
 #define I2C_BUFFER_LEN 8
 #define I2C0           5
+#define imu_stream_buffer_size 32 // power of two
+#define imu_max_batch          8
+#define imu_cordic_iterations  16
 
 /* The mbed library */
 #include <mbed.h>
 #include <drivers/bno055.hpp>
 #include <utils/task.hpp>
+#include <utils/textparser.hpp>
+#include <utils/textformatter.hpp>
+#include <utils/ringbuffer.hpp>
+#include <drivers/i2cengine.hpp>
+#include <drivers/bno055shadow.hpp>
+#include <drivers/serialtransmitter.hpp>
 #include <brain/globalsv.hpp>
 #include <chrono>
 
 namespace periodics
 {
+   /**
+    * @brief Latest values read from the IMU, the Euler angles in millidegrees and the velocities in mm/s
+    */
+    struct SImuSample
+    {
+        /** @brief  sequence number of the sample, it's incremented at each new sample */
+        uint32_t sequence;
+        int32_t roll;
+        int32_t pitch;
+        int32_t heading;
+        int32_t velocityX;
+        int32_t velocityY;
+        int32_t velocityZ;
+    };
+
+   /**
+    * @brief Sample of the high-rate stream, the raw values of the sensor: the Euler angles in 1/16 degree, 
+    * the linear acceleration in 1/100 m/s^2
+    */
+    struct SImuStreamSample
+    {
+        /** @brief  sequence number of the sample in the stream */
+        uint32_t sequence;
+        /** @brief  time of the reading in microseconds */
+        uint32_t time;
+        int16_t heading;
+        int16_t roll;
+        int16_t pitch;
+        int16_t accelX;
+        int16_t accelY;
+        int16_t accelZ;
+    };
+
    /**
     * @brief Class imu 
     * 
+    * The "#imu:1;;" command enables the messages with the period given in the constructor. The high-rate stream is started by the 
+    * "#imuStream:PERIOD;BATCH;;" command: the sensor is sampled with PERIOD milliseconds (10 ms, the fusion output rate of the sensor, 
+    * to 1000 ms, zero stops the stream) into a ring buffer and the samples are sent in batches of BATCH (1 to imu_max_batch) 
+    * samples, so the freshness of the data is PERIOD x BATCH:
+    * 
+    *   "@imuStream:SEQ;TIME;PERIOD;COUNT[;HEADING;ROLL;PITCH;AX;AY;AZ]...;;\r\n"
     * 
+    * SEQ is the sequence number of the first sample (a gap marks dropped samples), TIME is its time in microseconds on the board 
+    * clock, the next samples follow with PERIOD milliseconds. The angles are in degrees, the accelerations in m/s^2. In binary 
+    * mode the batch is sent in an ID_IMU_STREAM frame: u32 seq, u32 time, u16 period, u8 count and the raw values of the 
+    * samples, 6 x s16 (1/16 degree, 1/100 m/s^2). The batches are sent with telemetry priority, so they are dropped, when the 
+    * serial link is congested, the oldest samples are overwritten, when the buffer is full.
+    * 
+    * After the initialization the sensor is read in background by the I2C engine, the task doesn't wait for the bus. The latency 
+    * of the I2C transactions is reported by the "#i2c:0;;" command: "COUNT;ERRORS;LAST;MAX;MEAN" in microseconds.
+    * 
+    * The "#imuQuat:MODE;;" command selects the orientation of the messages enabled by "#imu:1;;": 0 the Euler angles (default), 
+    * 1 the quaternion, 2 the quaternion with the yaw and the yaw rate derived on the board in fixed-point:
+    * 
+    *   "@imuQuat:W;X;Y;Z[;YAW;YAWRATE];;\r\n"
+    * 
+    * The quaternion is in the Q14 unit of the sensor (16384 is 1), it's free of the gimbal lock of the Euler angles. YAW is the 
+    * rotation around the z axis of the sensor, atan2(2(wz+xy), 1-2(y^2+z^2)), counter-clockwise in degrees from -180 to 180, 
+    * YAWRATE is its change over the period of the messages in degrees/s. In binary mode an ID_IMU_QUAT frame is sent: 4 x s16 
+    * quaternion, in mode 2 followed by s32 yaw in millidegrees and s32 yaw rate in millidegrees/s.
     */
     class CImu : public utils::CTask
     {
@@ -55,7 +121,7 @@ namespace periodics
             /* Constructor */
             CImu(
                 std::chrono::milliseconds    f_period,
-                UnbufferedSerial& f_serial,
+                drivers::CSerialTransmitter& f_serial,
                 PinName SDA,
                 PinName SCL
             );
@@ -69,6 +135,16 @@ namespace periodics
             static void BNO055_delay_msek(u32 msek);
             /* Serial callback implementation */
             void serialCallbackIMUcommand(char const * a, char * b);
+            /* Serial callback implementation */
+            void serialCallbackIMUSTREAMcommand(char const * a, char * b);
+            /* Serial callback implementation */
+            void serialCallbackI2Ccommand(char const * a, char * b);
+            /* Serial callback implementation */
+            void serialCallbackIMUQUATcommand(char const * a, char * b);
+            /** @brief  Keeps the sensor sampled also when the messages of the task are disabled, at least with the given period */
+            void setSamplingPeriod(uint16_t f_period);
+            /** @brief  Latest sample */
+            const SImuSample& getSample();
         private:
             /*I2C init routine */
             virtual void I2C_routine(void);
@@ -76,6 +152,20 @@ namespace periodics
             // s32 bno055_data_readout_template(void);
             /* Run method */
             virtual void    _run();
+            /* Wakeup callback of the I2C engine */
+            void i2cWakeup();
+            /* Completion of the burst read */
+            void fusionReadCallback(int f_result);
+            /* Processes a sample */
+            void processSample(const struct bno055_fusion_t& f_fusion);
+            /* Applies the shortest requested period */
+            void updatePeriod();
+            /* Stores the sample in the stream */
+            void pushStream(const struct bno055_fusion_t& f_fusion);
+            /* Sends a batch of the stream */
+            void sendStream();
+            /* Sends the quaternion message */
+            void sendQuaternion(const struct bno055_quaternion_t& f_quaternion);
 
             /*----------------------------------------------------------------------------*
             *  struct bno055_t parameters can be accessed by using BNO055
@@ -97,15 +187,56 @@ namespace periodics
             /** @brief Active flag  */
             bool            m_isActive;
 
+            /** @brief Sampling flag, the sensor is read without sending the messages */
+            bool            m_isSampling;
+
+            /** @brief Latest sample */
+            SImuSample      m_sample;
+
             /* @brief Serial communication obj.  */
-            UnbufferedSerial&      m_serial;
+            drivers::CSerialTransmitter& m_serial;
 
             s32 m_velocityX;
             s32 m_velocityY;
             s32 m_velocityZ;
-            uint8_t m_velocityStationaryCounter;
+            /* @brief The last readings were stationary */
+            bool m_isStationary;
+            /* @brief Time of the first stationary reading in microseconds, the velocity is reset 1.5s after it */
+            uint32_t m_stationaryStart;
             uint64_t m_delta_time;
             uint8_t m_period;
+            /* @brief Period of the task given in the constructor, in milliseconds */
+            uint16_t m_defaultPeriod;
+            /* @brief Sampling period requested by setSamplingPeriod, zero without request */
+            uint16_t m_samplingPeriod;
+            /* @brief Time since the last message in milliseconds, the messages keep the period given in the constructor */
+            uint16_t m_messageElapsed;
+            /* @brief Period of the stream in milliseconds, zero stops the stream */
+            uint16_t m_streamPeriod;
+            /* @brief Number of the samples in a batch */
+            uint8_t m_streamBatch;
+            /* @brief Time since the last sample of the stream in milliseconds */
+            uint16_t m_streamElapsed;
+            /* @brief Sequence number of the next sample of the stream */
+            uint32_t m_streamSequence;
+            /* @brief Samples of the stream waiting for sending */
+            utils::CRingBuffer<SImuStreamSample, imu_stream_buffer_size> m_stream;
+            /* @brief Engine of the I2C transactions, the samples are read in background */
+            drivers::CI2CEngine m_i2c;
+            /* @brief Raw bytes of the fusion data block */
+            uint8_t m_fusionRaw[BNO055_FUSION_DATA_SIZE];
+            /* @brief The burst read is in progress */
+            bool m_reading;
+            /* @brief Start time of the last burst read in microseconds */
+            uint32_t m_readTime;
+            /* @brief Orientation of the messages: 0 Euler angles, 1 quaternion, 2 quaternion with yaw and yaw rate */
+            uint8_t m_quatMode;
+            /* @brief Yaw of the previous quaternion message in millidegrees */
+            int32_t m_lastYaw;
+            /* @brief Time of the previous quaternion message in microseconds, it's the time of the reading */
+            uint32_t m_lastYawTime;
+            /* @brief The previous yaw is valid for the yaw rate */
+            bool m_lastYawValid;
     }; // class CImu
 
 }; // namespace utils
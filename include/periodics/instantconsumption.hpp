@@ -37,6 +37,9 @@
 #include <mbed.h>
 /* Header file for the task manager library, which  applies periodically the fun function of it's children*/
 #include <utils/task.hpp>
+#include <utils/textparser.hpp>
+#include <utils/textformatter.hpp>
+#include <drivers/serialtransmitter.hpp>
 #include <brain/globalsv.hpp>
 
 #include <vector>
@@ -57,7 +60,7 @@ namespace periodics
             CInstantConsumption(
                 std::chrono::milliseconds f_period, 
                 mbed::AnalogIn f_pin, 
-                UnbufferedSerial& f_serial
+                drivers::CSerialTransmitter& f_serial
             );
             /* Destructor */
             ~CInstantConsumption();
@@ -65,6 +68,8 @@ namespace periodics
             void serialCallbackINSTANTcommand(char const * a, char * b);
 
             void void_InstantSafetyMeasure(uint16_t task_period);
+            /* Latest smoothed instant consumption */
+            uint32_t getCurrent();
         private:
             /* Run method */
             virtual void        _run();
@@ -74,7 +79,7 @@ namespace periodics
             /** @brief Active flag  */
             bool            m_isActive;
             /* @brief Serial communication obj.  */
-            UnbufferedSerial&          m_serial;
+            drivers::CSerialTransmitter& m_serial;
 
             uint64_t m_period;
     }; // class CInstantConsumption
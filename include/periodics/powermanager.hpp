@@ -35,6 +35,8 @@
 #include <mbed.h>
 /* Header file for the task manager library, which  applies periodically the fun function of it's children*/
 #include <utils/task.hpp>
+#include <drivers/serialtransmitter.hpp>
+#include <utils/textformatter.hpp>
 #include <brain/globalsv.hpp>
 #include <brain/klmanager.hpp>
 #include <periodics/totalvoltage.hpp>
@@ -55,7 +57,7 @@ namespace periodics
             CPowermanager(
                 std::chrono::milliseconds f_period,
                 brain::CKlmanager& f_CKlmanager,
-                UnbufferedSerial& f_serial,
+                drivers::CSerialTransmitter& f_serial,
                 periodics::CTotalVoltage& f_totalVoltage,
                 periodics::CInstantConsumption& f_instantConsumption,
                 periodics::CAlerts& f_alerts
@@ -70,7 +72,7 @@ namespace periodics
 
             brain::CKlmanager& m_CKlmanager;
 
-            UnbufferedSerial& m_serial;
+            drivers::CSerialTransmitter& m_serial;
 
             periodics::CTotalVoltage& m_totalVoltage;
 
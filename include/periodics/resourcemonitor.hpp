@@ -5,12 +5,29 @@
 
 #include <mbed.h>
 #include <utils/task.hpp>
+#include <utils/taskmanager.hpp>
+#include <utils/textparser.hpp>
+#include <utils/textformatter.hpp>
+#include <drivers/serialtransmitter.hpp>
+#include <drivers/serialmonitor.hpp>
 #include "mbed_stats.h"
 #include <brain/globalsv.hpp>
 #include <chrono>
 
 namespace periodics
 {
+   /**
+    * @brief Usage of the resources, the percentages in hundredths of percent and the wake-up jitter in microseconds
+    */
+    struct SResourceUsage
+    {
+        uint16_t heap;
+        uint16_t stack;
+        uint16_t idle;
+        uint32_t jitterMax;
+        uint32_t jitterMean;
+    };
+
    /**
     * @brief Class resourcemonitor
     *
@@ -21,20 +38,38 @@ namespace periodics
             /* Construnctor */
             CResourcemonitor(
                 std::chrono::milliseconds f_period,
-                UnbufferedSerial& f_serial
+                drivers::CSerialTransmitter& f_serial,
+                utils::CTaskManager& f_taskManager,
+                drivers::CSerialMonitor& f_serialMonitor
             );
             /* Destructor */
             ~CResourcemonitor();
 
             void serialCallbackRESMONCommand(char const * a, char * b);
 
+            void serialCallbackTASKSTATSCommand(char const * a, char * b);
+
+            /* Current usage of the resources */
+            void getUsage(SResourceUsage& f_usage);
+
         private:
             /* private variables & method member */
             virtual void    _run();
 
-            UnbufferedSerial& m_serial;
+            /* Sends the execution statistics of the tasks, one line per task */
+            void sendTaskStats();
+
+            drivers::CSerialTransmitter& m_serial;
+
+            /* Task manager, which measures the idle time and the wake-up jitter */
+            utils::CTaskManager& m_taskManager;
+
+            /* Serial monitor, its receiver counts the lost characters and the line errors */
+            drivers::CSerialMonitor& m_serialMonitor;
 
             bool m_isActive;
+
+            bool m_taskStatsActive;
     }; // class CResourcemonitor
 }; // namespace drivers
 
@@ -0,0 +1,165 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+/* Include guard */
+#ifndef TELEMETRY_HPP
+#define TELEMETRY_HPP
+
+/* The mbed library */
+#include <mbed.h>
+/* Header file for the task manager library, which  applies periodically the fun function of it's children*/
+#include <utils/task.hpp>
+#include <utils/textparser.hpp>
+#include <utils/textformatter.hpp>
+#include <utils/binaryframe.hpp>
+#include <drivers/serialtransmitter.hpp>
+#include <periodics/imu.hpp>
+#include <periodics/totalvoltage.hpp>
+#include <periodics/instantconsumption.hpp>
+#include <periodics/resourcemonitor.hpp>
+#include <periodics/clocksync.hpp>
+#include <brain/globalsv.hpp>
+#include <chrono>
+
+namespace periodics
+{
+   /**
+    * @brief It aims to collect the latest values of the IMU, of the battery, of the instant consumption and of the resource monitor 
+    * and to send them in one timestamped message per cycle, instead of one message per producer. The host subscribes to the topics 
+    * with the "#sub:TOPIC;PERIOD[;DEADBAND];;" command: TOPIC is imu, battery, instant or resourceMonitor, PERIOD in milliseconds 
+    * (zero unsubscribes), it's rounded up to a multiple of the resolution given to the constructor. With a non-zero DEADBAND the topic is checked with the 
+    * period, but it's sent only when one of its fields moved at least with the deadband (in the unit of the field) from the last sent 
+    * value. The subscription of the IMU raises the sampling rate of the sensor to the period. The topics, which are due in the same 
+    * cycle, are sent together, in the order of the topics:
+    * 
+    *   "@telemetry:TIME;MASK[;ROLL;PITCH;HEADING;VX;VY;VZ][;VOLTAGE][;CURRENT][;HEAP;STACK;IDLE;JITTER_MAX;JITTER_MEAN];;\r\n"
+    * 
+    * TIME is the time of the reading in microseconds (modulo 2^32), MASK has one bit for each topic (bit 0 imu, bit 1 battery, 
+    * bit 2 instant, bit 3 resourceMonitor). The bit 7 (host_time_flag) of MASK is set, when the board time was mapped to the host 
+    * clock by the synchronised CClockSync, otherwise TIME is the board time. The units are the units of the messages of the 
+    * producers. In binary mode the fields are sent in a ID_TELEMETRY frame: u32 time, u8 mask, imu 6 x s32 (millidegrees, mm/s), 
+    * battery u16 (mV), instant u32 (mA), 
+    * resourceMonitor 3 x u16 (hundredths of percent) and 2 x u32 (us).
+    * 
+    * The telemetry backs off, while the serial link is congested: the periods of all topics are doubled each second (at most 
+    * max_slowdown times) and restored step by step, when the load fell below the half of the congestion level. The load of the 
+    * link, the rejected telemetry characters, the slowdown and the characters per second of the sources are reported by the 
+    * "#bandwidth:0;;" command.
+    * 
+    * The task doesn't run with the resolution: its period follows the subscriptions (the shortest subscribed period, when the 
+    * others are its multiples) and it's one second without subscriptions.
+    */
+    class CTelemetry : public utils::CTask
+    {
+        public:
+            /** @brief  Topics of the telemetry, the order of the fields in the message */
+            enum ETopic
+            {
+                TOPIC_IMU = 0,
+                TOPIC_BATTERY,
+                TOPIC_INSTANT,
+                TOPIC_RESOURCE,
+                topic_count
+            };
+
+            /** @brief  Number of the fields of all topics */
+            static const uint8_t field_count = 13;
+
+            /** @brief  Maximum number of the doublings of the periods on congestion */
+            static const uint8_t max_slowdown = 3;
+
+            /** @brief  Flag of the mask, the time of the message is host time */
+            static const uint8_t host_time_flag = 0x80;
+
+            /* Constructor */
+            CTelemetry(
+                std::chrono::milliseconds f_period,
+                drivers::CSerialTransmitter& f_serial,
+                CImu& f_imu,
+                CTotalVoltage& f_totalVoltage,
+                CInstantConsumption& f_instantConsumption,
+                CResourcemonitor& f_resourceMonitor,
+                CClockSync& f_clockSync
+            );
+            /* Destructor */
+            ~CTelemetry();
+            /* Serial callback implementation */
+            void serialCallbackSUBcommand(char const * a, char * b);
+            /* Serial callback implementation */
+            void serialCallbackBANDWIDTHcommand(char const * a, char * b);
+            /* Subscribes to the topic */
+            uint32_t subscribe(ETopic f_topic, uint32_t f_period, uint32_t f_deadband);
+        private:
+            /* Run method */
+            virtual void _run();
+            /* Applies the period of the task to the subscriptions */
+            void updatePeriod();
+            /* Adapts the periods to the load of the serial link */
+            void updateSlowdown(uint32_t f_time);
+            /* Reads the latest values of the topic */
+            void readTopic(ETopic f_topic);
+            /* Check the topic moved out of its deadband */
+            bool isChanged(ETopic f_topic);
+            /* Sends the topics in text */
+            void sendText(uint32_t f_time, uint8_t f_mask);
+            /* Sends the topics in a binary frame */
+            void sendBinary(uint32_t f_time, uint8_t f_mask);
+
+            /** @brief Serial communication obj. */
+            drivers::CSerialTransmitter& m_serial;
+            /** @brief Producers of the topics */
+            CImu& m_imu;
+            CTotalVoltage& m_totalVoltage;
+            CInstantConsumption& m_instantConsumption;
+            CResourcemonitor& m_resourceMonitor;
+            /** @brief Synchronisation of the time stamps to the host clock */
+            CClockSync& m_clockSync;
+            /** @brief Resolution of the topics' periods in milliseconds */
+            uint32_t m_basePeriod;
+            /** @brief Period of the topics in cycles of the resolution, zero for the topics without subscription */
+            uint16_t m_topicCycles[topic_count];
+            /** @brief Cycles of the resolution until the next check of the topics */
+            uint16_t m_topicCounters[topic_count];
+            /** @brief Cycles of the resolution per run of the task, zero without subscriptions */
+            uint16_t m_stepCycles;
+            /** @brief Deadband of the topics, zero for periodic sending */
+            uint32_t m_deadbands[topic_count];
+            /** @brief Latest values of the fields */
+            int32_t m_values[field_count];
+            /** @brief Last sent values of the fields */
+            int32_t m_sentValues[field_count];
+            /** @brief Number of the doublings of the periods */
+            uint8_t m_slowdown;
+            /** @brief Time of the last change of the slowdown in milliseconds */
+            uint32_t m_slowdownTime;
+    }; // class CTelemetry
+}; // namespace periodics
+
+#endif // TELEMETRY_HPP
\ No newline at end of file
@@ -37,6 +37,9 @@
 #include <mbed.h>
 /* Header file for the task manager library, which  applies periodically the fun function of it's children*/
 #include <utils/task.hpp>
+#include <utils/textparser.hpp>
+#include <utils/textformatter.hpp>
+#include <drivers/serialtransmitter.hpp>
 #include <brain/globalsv.hpp>
 #include <chrono>
 
@@ -53,7 +56,7 @@ namespace periodics
             CTotalVoltage(
                 std::chrono::milliseconds f_period,
                 mbed::AnalogIn f_pin, 
-                UnbufferedSerial& f_serial
+                drivers::CSerialTransmitter& f_serial
             );
             /* Destructor */
             ~CTotalVoltage();
@@ -61,13 +64,15 @@ namespace periodics
             void serialCallbackTOTALVcommand(char const * a, char * b);
 
             void void_TotalSafetyMeasure();
+            /* Latest battery voltage */
+            uint16_t getVoltage();
         private:
             /* Run method */
             virtual void        _run();
             /* ADC input pin for instand consume */
             mbed::AnalogIn      m_pin;  
             /* @brief Serial communication obj.  */
-            UnbufferedSerial&          m_serial;
+            drivers::CSerialTransmitter& m_serial;
             /** @brief Active flag  */
             bool                m_isActive;
             /* @brief ADC counter */
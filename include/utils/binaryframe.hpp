@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+/* Inclusion guard */
+#ifndef BINARY_FRAME_HPP
+#define BINARY_FRAME_HPP
+
+#include <stdint.h>
+
+#define binary_payload_max  128
+// Identifier, payload and CRC, the COBS overhead of one byte per 254 bytes and the delimiter
+#define binary_frame_max    (binary_payload_max + 3 + (binary_payload_max + 3) / 254 + 2)
+
+namespace utils
+{
+   /**
+    * @brief It aims to build and check the frames of the binary serial protocol. The frame contains the one byte identifier of the 
+    * command, the payload and the CRC-16/CCITT-FALSE of the identifier and payload (little-endian). It is encoded with COBS 
+    * (Consistent Overhead Byte Stuffing), so the encoded frame contains no zero byte and the zero byte delimits the frames:
+    * 
+    *   COBS(ID | PAYLOAD | CRC16) 0x00
+    * 
+    * The numeric fields of the payloads are packed in little-endian order.
+    */
+    class CBinaryFrame
+    {
+        public:
+            /* Encodes a frame with the delimiter */
+            static uint32_t encode(uint8_t f_id, const uint8_t* f_payload, uint32_t f_length, uint8_t* f_frame);
+            /* Decodes a frame in place and checks its CRC */
+            static int32_t decode(uint8_t* f_frame, uint32_t f_length);
+            /* CRC-16/CCITT-FALSE */
+            static uint16_t crc16(const uint8_t* f_data, uint32_t f_length, uint16_t f_crc = 0xFFFF);
+
+            /** @brief  Writes a 16-bit value in little-endian order, it returns the position after the value */
+            static inline uint8_t* putU16(uint8_t* f_buffer, uint16_t f_value)
+            {
+                f_buffer[0] = (uint8_t)f_value;
+                f_buffer[1] = (uint8_t)(f_value >> 8);
+                return f_buffer + 2;
+            }
+
+            /** @brief  Writes a 32-bit value in little-endian order, it returns the position after the value */
+            static inline uint8_t* putU32(uint8_t* f_buffer, uint32_t f_value)
+            {
+                f_buffer = putU16(f_buffer, (uint16_t)f_value);
+                return putU16(f_buffer, (uint16_t)(f_value >> 16));
+            }
+    }; // class CBinaryFrame
+
+}; // namespace utils
+
+#endif // BINARY_FRAME_HPP
\ No newline at end of file
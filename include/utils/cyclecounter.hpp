@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+/* Inclusion guard */
+#ifndef CYCLE_COUNTER_HPP
+#define CYCLE_COUNTER_HPP
+
+#include <mbed.h>
+#include <chrono>
+
+namespace utils
+{
+   /**
+    * @brief It aims to measure short durations with the resolution of the CPU clock. On the target it reads the DWT cycle counter
+    * of the Cortex-M core, on the host (where the DWT unit doesn't exist) the steady clock is used as stand-in, with one count 
+    * per nanosecond. The counter overflows (every ~51s at 84MHz), so only the differences of two readings are meaningful.
+    */
+    class CCycleCounter
+    {
+        public:
+            /** @brief  Enables the cycle counter */
+            static inline void init()
+            {
+#if defined(DWT) && defined(CoreDebug)
+                CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+                DWT->CYCCNT = 0;
+                DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+            }
+
+            /** @brief  Current value of the counter */
+            static inline uint32_t read()
+            {
+#if defined(DWT) && defined(CoreDebug)
+                return DWT->CYCCNT;
+#else
+                return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+            }
+
+            /** @brief  Number of counts per microsecond */
+            static inline uint32_t countsPerMicrosecond()
+            {
+#if defined(DWT) && defined(CoreDebug)
+                return SystemCoreClock / 1000000;
+#else
+                return 1000;
+#endif
+            }
+
+            /** @brief  Converts the counts to microseconds */
+            static inline uint32_t toMicroseconds(uint32_t f_counts)
+            {
+                return f_counts / countsPerMicrosecond();
+            }
+    }; // class CCycleCounter
+
+}; // namespace utils
+
+#endif // CYCLE_COUNTER_HPP
\ No newline at end of file
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+/* Include guard */
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <atomic>
+#include <stdint.h>
+
+namespace utils
+{
+    /**
+     * @brief Lock-free ring buffer for a single producer and a single consumer (e.g. an interrupt and a task).
+     * 
+     * The read and write indices are free running counters, each of them is modified only by one side, the other side reads it 
+     * with acquire ordering. So no interrupt has to be disabled for accessing the buffer. The capacity has to be a power of two, 
+     * the position in the buffer is given by masking the counter and all the N elements can be used.
+     * 
+     * @tparam T The type of the elements
+     * @tparam N The capacity of the buffer, power of two
+     */
+    template <class T, uint32_t N>
+    class CRingBuffer
+    {
+        static_assert((N > 0) && ((N & (N - 1)) == 0), "The capacity of the ring buffer has to be a power of two");
+
+        public:
+            /* Constructor */
+            CRingBuffer();
+            /* Is full method */
+            inline bool isFull() const;
+            /* Is empty method */
+            inline bool isEmpty() const;
+            /* Number of the stored elements */
+            inline uint32_t getSize() const;
+            /* Capacity of the buffer */
+            inline uint32_t getCapacity() const;
+            /* Push single element, producer side */
+            inline bool push(const T& f_item);
+            /* Push multiple elements, producer side */
+            inline uint32_t push(const T* f_items, uint32_t f_len);
+            /* Pop single element, consumer side */
+            inline bool pop(T& f_item);
+            /* Pop multiple elements, consumer side */
+            inline uint32_t pop(T* f_items, uint32_t f_len);
+            /* Contiguous readable elements, consumer side */
+            inline uint32_t peek(const T*& f_items) const;
+            /* Removes the peeked elements, consumer side */
+            inline void consume(uint32_t f_len);
+        private:
+            /** @brief  buffer */
+            T m_buffer[N];
+            /** @brief  write counter, modified by the producer */
+            std::atomic<uint32_t> m_head;
+            /** @brief  read counter, modified by the consumer */
+            std::atomic<uint32_t> m_tail;
+    }; // class CRingBuffer
+    #include "ringbuffer.tpp"
+}; // namespace utils
+
+#endif // RING_BUFFER_HPP
\ No newline at end of file
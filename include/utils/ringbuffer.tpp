@@ -0,0 +1,193 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+#ifndef RING_BUFFER_TPP
+#define RING_BUFFER_TPP
+
+#ifndef RING_BUFFER_HPP
+#error __FILE__ should only be included from ringbuffer.hpp.
+#endif
+
+/** @brief  Ring buffer class constructor
+ *
+ *  Constructor method, the buffer is empty.
+ */
+template <class T, uint32_t N>
+CRingBuffer<T,N>::CRingBuffer()
+    : m_buffer()
+    , m_head(0)
+    , m_tail(0)
+{
+}
+
+/** @brief  Is full method
+ *
+ *  @return    True if the buffer is full
+ */
+template <class T, uint32_t N>
+bool CRingBuffer<T,N>::isFull() const
+{
+    return getSize() == N;
+}
+
+/** @brief  Is empty method
+ *
+ *  @return    True if the buffer is empty
+ */
+template <class T, uint32_t N>
+bool CRingBuffer<T,N>::isEmpty() const
+{
+    return getSize() == 0;
+}
+
+/** @brief  Get size method
+ *
+ *  @return    Number of the stored elements
+ */
+template <class T, uint32_t N>
+uint32_t CRingBuffer<T,N>::getSize() const
+{
+    return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+}
+
+/** @brief  Get capacity method
+ *
+ *  @return    Maximum number of the stored elements
+ */
+template <class T, uint32_t N>
+uint32_t CRingBuffer<T,N>::getCapacity() const
+{
+    return N;
+}
+
+/** @brief  Push method
+ * 
+ *  Method for inserting an element, it can be applied only by the producer.
+ *
+ *  @param f_item    element to be added
+ *  @return    False if the buffer is full and the element was dropped
+ */
+template <class T, uint32_t N>
+bool CRingBuffer<T,N>::push(const T& f_item)
+{
+    return push(&f_item, 1) == 1;
+}
+
+/** @brief  Push method
+ * 
+ *  Method for inserting a sequence of elements, it can be applied only by the producer. The elements, which don't fit, are dropped.
+ *
+ *  @param f_items   pointer to the elements to be added
+ *  @param f_len     number of elements to be added
+ *  @return    Number of the added elements
+ */
+template <class T, uint32_t N>
+uint32_t CRingBuffer<T,N>::push(const T* f_items, uint32_t f_len)
+{
+    uint32_t l_head = m_head.load(std::memory_order_relaxed);
+    uint32_t l_free = N - (l_head - m_tail.load(std::memory_order_acquire));
+    if (f_len > l_free) f_len = l_free;
+
+    for (uint32_t l_idx = 0; l_idx < f_len; ++l_idx)
+    {
+        m_buffer[(l_head + l_idx) & (N - 1)] = f_items[l_idx];
+    }
+    m_head.store(l_head + f_len, std::memory_order_release);
+    return f_len;
+}
+
+/** @brief  Pop method
+ * 
+ *  Method for removing the oldest element, it can be applied only by the consumer.
+ *
+ *  @param f_item    the removed element
+ *  @return    False if the buffer is empty
+ */
+template <class T, uint32_t N>
+bool CRingBuffer<T,N>::pop(T& f_item)
+{
+    return pop(&f_item, 1) == 1;
+}
+
+/** @brief  Pop method
+ * 
+ *  Method for removing a sequence of the oldest elements, it can be applied only by the consumer.
+ *
+ *  @param f_items   pointer to the destination
+ *  @param f_len     maximum number of elements to be removed
+ *  @return    Number of the removed elements
+ */
+template <class T, uint32_t N>
+uint32_t CRingBuffer<T,N>::pop(T* f_items, uint32_t f_len)
+{
+    uint32_t l_tail = m_tail.load(std::memory_order_relaxed);
+    uint32_t l_used = m_head.load(std::memory_order_acquire) - l_tail;
+    if (f_len > l_used) f_len = l_used;
+
+    for (uint32_t l_idx = 0; l_idx < f_len; ++l_idx)
+    {
+        f_items[l_idx] = m_buffer[(l_tail + l_idx) & (N - 1)];
+    }
+    m_tail.store(l_tail + f_len, std::memory_order_release);
+    return f_len;
+}
+
+/** @brief  Peek method
+ * 
+ *  It gives the oldest elements without removing them, only the contiguous part until the end of the buffer. 
+ *  The elements stay valid until they are consumed. It can be applied only by the consumer.
+ *
+ *  @param f_items   pointer to the oldest element
+ *  @return    Number of the contiguous elements
+ */
+template <class T, uint32_t N>
+uint32_t CRingBuffer<T,N>::peek(const T*& f_items) const
+{
+    uint32_t l_tail = m_tail.load(std::memory_order_relaxed);
+    uint32_t l_used = m_head.load(std::memory_order_acquire) - l_tail;
+    uint32_t l_pos = l_tail & (N - 1);
+
+    f_items = &m_buffer[l_pos];
+    return (l_used < N - l_pos) ? l_used : N - l_pos;
+}
+
+/** @brief  Consume method
+ * 
+ *  Removes the elements given by the peek method. It can be applied only by the consumer.
+ *
+ *  @param f_len     number of elements to be removed, at most the number given by peek
+ */
+template <class T, uint32_t N>
+void CRingBuffer<T,N>::consume(uint32_t f_len)
+{
+    m_tail.store(m_tail.load(std::memory_order_relaxed) + f_len, std::memory_order_release);
+}
+
+#endif // RING_BUFFER_TPP
\ No newline at end of file
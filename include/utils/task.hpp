@@ -33,17 +33,59 @@
 #define TASK_HPP
 
 #include <mbed.h>
+#include <utils/cyclecounter.hpp>
 #include <chrono>
 
 namespace utils
 {
+    class CTaskManager;
+
+   /**
+    * @brief Execution statistics of a task. The run times are measured in cycle counter units, the start latencies 
+    * (delay from the deadline to the start of the run) in microseconds.
+    */
+    struct STaskStats
+    {
+        /** @brief  number of runs */
+        uint32_t runCount;
+        /** @brief  minimum run time */
+        uint32_t runMin;
+        /** @brief  maximum run time */
+        uint32_t runMax;
+        /** @brief  sum of the run times */
+        uint64_t runSum;
+        /** @brief  maximum start latency */
+        uint32_t latencyMax;
+        /** @brief  sum of the start latencies */
+        uint64_t latencySum;
+        /** @brief  number of runs finished after the next deadline */
+        uint32_t overruns;
+        /** @brief  maximum number of consecutive overruns */
+        uint32_t consecutiveOverrunsMax;
+        /** @brief  number of skipped activations */
+        uint32_t missed;
+        /** @brief  number of runs finished after the hard deadline */
+        uint32_t hardMisses;
+    };
+
    /**
     * @brief It aims to the task functionality. The tasks will be applied periodically by the task manager, the period is defined in the contructor. 
-    * 
+    * The tasks with zero period are event driven, they are applied only after they were notified (e.g. from an interrupt).
     */
     class CTask
     {
         public:
+            /** @brief  Handling of the activations, which were missed, because the task was applied too late */
+            enum EOverrunPolicy
+            {
+                /** @brief  the missed activations are dropped, the task continues with the next deadline */
+                SKIP,
+                /** @brief  the missed activations are applied one after another, as soon as possible */
+                CATCH_UP,
+                /** @brief  the missed activations are dropped and reported to the task manager's deadline callback */
+                ALERT
+            };
+
             /* Constructor */
             CTask(
                 std::chrono::milliseconds f_period
@@ -52,19 +94,59 @@ namespace utils
             virtual ~CTask();
             /* Run method */
             virtual void run();
-            /** @brief  Timer callback */
+            /** @brief  Timer callback, it marks the task as due */
             void timerCallback();
+            /** @brief  Execution statistics */
+            const STaskStats& getStats();
+            /** @brief  Clears the execution statistics */
+            void resetStats();
+            /** @brief  Set the handling of the missed activations */
+            void setOverrunPolicy(EOverrunPolicy f_policy);
+            /** @brief  Set the hard deadline relative to the activation, zero disables it */
+            void setHardDeadline(std::chrono::milliseconds f_deadline);
+            /** @brief  Index of the task in the task manager's list */
+            uint8_t getId();
         protected:
             /** @brief  main application logic - It's a pure function for application logic and has to override in the derivered class to implement the appl.*/
             virtual void _run() = 0;
             /** @brief  Set new period */
             void setNewPeriod(uint16_t f_period);
+            /** @brief  Requests a run of the task and wakes up the task manager, it can be applied from interrupt context */
+            void notify();
             /** @brief period of the task */
             std::chrono::milliseconds m_period;
-            /** @brief  ticks */
-            std::chrono::milliseconds m_ticks;
             /** @brief  trigger flag */
             bool m_triggered;
+        private:
+            friend class CTaskManager;
+            /* Records the delay of the start from the deadline */
+            void recordLatency(uint32_t f_latency);
+            /* Records the run time */
+            void recordRun(uint32_t f_cycles);
+            /* Records the skipped activations */
+            void recordMissed(uint32_t f_missed);
+            /** @brief  task manager, which schedules the task */
+            CTaskManager* m_manager;
+            /** @brief  absolute time of the next activation in milliseconds */
+            uint32_t m_deadline;
+            /** @brief  position of the task in the scheduler's heap */
+            uint8_t m_heapIndex;
+            /** @brief  time of the first notification before the run in microseconds */
+            uint32_t m_notifyTime;
+            /** @brief  start latency of the current run in microseconds */
+            uint32_t m_latency;
+            /** @brief  execution statistics */
+            STaskStats m_stats;
+            /** @brief  number of the overruns in a row */
+            uint32_t m_consecutiveOverruns;
+            /** @brief  handling of the missed activations */
+            EOverrunPolicy m_overrunPolicy;
+            /** @brief  hard deadline relative to the activation in milliseconds */
+            uint32_t m_hardDeadline;
+            /** @brief  the last run missed the hard deadline, the stall has been reported */
+            bool m_stalled;
+            /** @brief  index of the task in the task manager's list */
+            uint8_t m_id;
     }; // class CTask
 
 }; // namespace utils
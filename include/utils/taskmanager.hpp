@@ -40,13 +40,20 @@ namespace utils
 {
    /**
     * @brief It aims to implement the task manager functionality. It controls and applies periodically each task. 
-    * It has two main part, a ticker and the mainCallback method. The ticker method applies automatically 'timerCallback' method of each tasks, so
-    * numerate separately the ticks from the functionalities of tasks. The mainCallback method aims to apply the application logic for each tasks, 
-    * if the task's trigger flag has true state. 
+    * The tasks are kept in a min-heap ordered by their next deadline, the mainCallback method aims to apply the application logic 
+    * only for the tasks from the top of the heap, which deadline has been reached. There is no periodic tick, after applying the 
+    * due tasks the manager sleeps until the earliest deadline or until it is woken up by an interrupt (e.g. the serial reception). 
+    * The tasks with zero period aren't in the heap, they are applied only after a notification. At most 32 tasks are supported. 
+    * The idle time and the wake-up jitter are measured over windows of one second. The missed activations are handled according to 
+    * the overrun policy of each task, the alerts and the hard deadline misses are reported through the deadline callback, a hard 
+    * deadline miss once per stall.
     */
     class CTaskManager
     {
         public:
+            /** @brief  Deadline callback, it receives the task and true for a hard deadline miss, false for missed activations */
+            typedef mbed::Callback<void(utils::CTask&, bool)> FDeadlineCallback;
+
             /* Constructor */ 
             CTaskManager(
                 utils::CTask** f_taskList,
@@ -57,16 +64,81 @@ namespace utils
             virtual ~CTaskManager();
             /** @brief  The main callback method aims to apply the subtasks' run method. */
             void mainCallback();
-            /** @brief  Timer callback method applies the subtasks' callback function. */
-            void timerCallback();
+            /** @brief  Wakes up the manager from the idle state, it can be applied from interrupt context. */
+            void wakeUp();
+            /** @brief  Marks the task for running and wakes up the manager, it can be applied from interrupt context. */
+            void notify(utils::CTask& f_task);
+            /** @brief  Attach the callback applied on missed deadlines */
+            void attachDeadlineCallback(FDeadlineCallback f_callback);
+            /** @brief  Recomputes the deadline of the task after its period has been changed. */
+            void reschedule(utils::CTask& f_task);
+            /** @brief  Idle time in the last window, in hundredths of percent */
+            uint16_t getIdlePercent();
+            /** @brief  Maximum wake-up delay in the last window, in microseconds */
+            uint32_t getWakeupJitterMax();
+            /** @brief  Average wake-up delay in the last window, in microseconds */
+            uint32_t getWakeupJitterMean();
+            /** @brief  Number of tasks */
+            uint8_t getTaskCount();
+            /** @brief  Task from the list, in the order of the list given to the constructor */
+            utils::CTask* getTask(uint8_t f_index);
         private:
+            /* Applies the notified tasks */
+            void runNotified();
+            /* Checks the hard deadline of the task after its run */
+            void checkHardDeadline(utils::CTask& f_task, uint32_t f_activation);
+            /* Sleeps until the deadline or until the manager is woken up */
+            void idle(uint32_t f_deadline);
+            /* Current time in milliseconds */
+            inline uint32_t getNow();
+            /* Check the deadline has been reached */
+            static inline bool isDue(uint32_t f_deadline, uint32_t f_now);
+            /* Check the first deadline is before the second one */
+            static inline bool isEarlier(uint32_t f_first, uint32_t f_second);
+            /* Period of the task in milliseconds, it's at least one base tick */
+            inline uint32_t getPeriod(utils::CTask& f_task);
+            /* Move the task up in the heap */
+            void siftUp(uint8_t f_index);
+            /* Move the task down in the heap */
+            void siftDown(uint8_t f_index);
+            /* Place the task on the position of the heap */
+            inline void place(utils::CTask* f_task, uint8_t f_index);
+
             /** @brief  List of tasks  */
             utils::CTask** m_taskList;
             /** @brief  number of tasks */
             uint8_t m_taskCount;
-            /** @brief  Ticker for periodic applying the timer callback function  */
-            Ticker m_ticker;
-            
+            /** @brief  Min-heap of the periodic tasks ordered by their deadline */
+            utils::CTask** m_heap;
+            /** @brief  number of tasks in the heap */
+            uint8_t m_heapCount;
+            /** @brief  Notified tasks, one bit for each task index */
+            volatile uint32_t m_notified;
+            /** @brief  Base tick in milliseconds */
+            uint32_t m_baseTick;
+            /** @brief  Callback applied on missed deadlines */
+            FDeadlineCallback m_deadlineCallback;
+            /** @brief  Timer for the time base of the deadlines */
+            Timer m_timer;
+            /** @brief  Event flags for waking up the manager from idle */
+            EventFlags m_wakeFlags;
+            /** @brief  Start of the measurement window in microseconds */
+            uint64_t m_windowStart;
+            /** @brief  Time spent in idle in the current window, in microseconds */
+            uint64_t m_idleTime;
+            /** @brief  Maximum wake-up delay in the current window */
+            uint32_t m_jitterMax;
+            /** @brief  Sum of the wake-up delays in the current window */
+            uint32_t m_jitterSum;
+            /** @brief  Number of timed wake-ups in the current window */
+            uint16_t m_jitterCount;
+            /** @brief  Idle time in the last window, in hundredths of percent */
+            uint16_t m_idlePercent;
+            /** @brief  Maximum wake-up delay in the last window */
+            uint32_t m_lastJitterMax;
+            /** @brief  Average wake-up delay in the last window */
+            uint32_t m_lastJitterMean;
+
     }; // class CTaskManager
 
 }; // namespace utils
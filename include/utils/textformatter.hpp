@@ -0,0 +1,156 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+/* Inclusion guard */
+#ifndef TEXT_FORMATTER_HPP
+#define TEXT_FORMATTER_HPP
+
+#include <stdint.h>
+
+namespace utils
+{
+   /**
+    * @brief It aims to build the text messages of the serial protocol without the printf family of the standard library. The 
+    * characters are written directly into the buffer of the caller, which is kept null-terminated; the text, which doesn't fit, 
+    * is truncated like by snprintf. The methods can be chained:
+    * 
+    *   char l_buffer[_24_chars];
+    *   CTextFormatter l_text(l_buffer, sizeof(l_buffer));
+    *   l_text.append("@speed:").appendSigned(l_speed).append(";;\r\n");
+    *   m_serial.write(l_buffer, l_text.length());
+    * 
+    * The fixed-point values are written with the given number of decimals, appendFixed(-1250, 3) gives "-1.250".
+    */
+    class CTextFormatter
+    {
+        public:
+            constexpr CTextFormatter(char* f_buffer, uint32_t f_size)
+                : m_buffer(f_buffer)
+                , m_size(f_size)
+                , m_length(0)
+            {
+                if (f_size > 0) f_buffer[0] = '\0';
+            }
+
+            /** @brief  It appends a null-terminated text */
+            constexpr CTextFormatter& append(const char* f_text)
+            {
+                while (*f_text != '\0') appendChar(*f_text++);
+                return *this;
+            }
+
+            /** @brief  It appends a character */
+            constexpr CTextFormatter& appendChar(char f_char)
+            {
+                if (m_length + 1 < m_size)
+                {
+                    m_buffer[m_length++] = f_char;
+                    m_buffer[m_length] = '\0';
+                }
+                return *this;
+            }
+
+            /** @brief  It appends an unsigned integer, completed with leading zeros to f_width digits */
+            constexpr CTextFormatter& appendUnsigned(uint32_t f_value, uint8_t f_width = 1)
+            {
+                char l_digits[10] = {0};
+                uint8_t l_count = 0;
+                do
+                {
+                    l_digits[l_count++] = (char)('0' + f_value % 10);
+                    f_value /= 10;
+                } while (f_value > 0);
+                for (; f_width > l_count; f_width--) appendChar('0');
+                while (l_count > 0) appendChar(l_digits[--l_count]);
+                return *this;
+            }
+
+            /** @brief  It appends a signed integer */
+            constexpr CTextFormatter& appendSigned(int32_t f_value)
+            {
+                if (f_value < 0) appendChar('-');
+                return appendUnsigned(magnitude(f_value));
+            }
+
+            /** @brief  It appends a fixed-point value with f_decimals fractional digits, the sign is kept also for the values 
+             * between -1 and 0 */
+            constexpr CTextFormatter& appendFixed(int32_t f_value, uint8_t f_decimals)
+            {
+                uint32_t l_scale = 1;
+                for (uint8_t i = 0; i < f_decimals; i++) l_scale *= 10;
+
+                uint32_t l_magnitude = magnitude(f_value);
+                if (f_value < 0) appendChar('-');
+                appendUnsigned(l_magnitude / l_scale);
+                if (f_decimals > 0)
+                {
+                    appendChar('.');
+                    appendUnsigned(l_magnitude % l_scale, f_decimals);
+                }
+                return *this;
+            }
+
+            /** @brief  Length of the text without the terminating null character */
+            constexpr uint32_t length() const
+            {
+                return m_length;
+            }
+
+            /** @brief  Restarts the text at the beginning of the buffer */
+            constexpr void clear()
+            {
+                m_length = 0;
+                if (m_size > 0) m_buffer[0] = '\0';
+            }
+
+            /** @brief  It checks whether the text was truncated */
+            constexpr bool isFull() const
+            {
+                return (m_size == 0) || (m_length + 1 >= m_size);
+            }
+
+        private:
+            /** @brief  Absolute value of a signed integer, also for INT32_MIN */
+            static constexpr uint32_t magnitude(int32_t f_value)
+            {
+                return (f_value < 0) ? (uint32_t)0 - (uint32_t)f_value : (uint32_t)f_value;
+            }
+
+            /** @brief  Buffer of the caller */
+            char* const m_buffer;
+            /** @brief  Size of the buffer with the terminating null character */
+            const uint32_t m_size;
+            /** @brief  Length of the text */
+            uint32_t m_length;
+    }; // class CTextFormatter
+
+}; // namespace utils
+
+#endif // TEXT_FORMATTER_HPP
\ No newline at end of file
@@ -0,0 +1,278 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+/* Inclusion guard */
+#ifndef TEXT_PARSER_HPP
+#define TEXT_PARSER_HPP
+
+#include <stdint.h>
+#include <string.h>
+
+namespace utils
+{
+   /**
+    * @brief It aims to read the fields of the serial commands without the sscanf of the standard library. It works in place on a 
+    * span of characters (begin and length, it isn't required to be null-terminated), it doesn't allocate and it uses a few bytes
+    * of stack. The fields are separated by the separator character (';' by default), each call of a next method reads the 
+    * following field and checks it completely, so "12a" or an out of range value is rejected instead of being truncated.
+    * The leading and trailing spaces of the fields are ignored.
+    * 
+    *   CTextParser l_parser(a);
+    *   int32_t l_speed; uint32_t l_time;
+    *   if (l_parser.next(l_speed, -500, 500) && l_parser.next(l_time, 0, 255)) { ... }
+    */
+    class CTextParser
+    {
+        public:
+            /** @brief  Parser of a null-terminated text */
+            explicit CTextParser(const char* f_text, char f_separator = ';')
+                : m_pos(f_text)
+                , m_end(f_text + strlen(f_text))
+                , m_separator(f_separator)
+            {
+            }
+
+            /** @brief  Parser of a span of characters */
+            CTextParser(const char* f_text, uint32_t f_length, char f_separator = ';')
+                : m_pos(f_text)
+                , m_end(f_text + f_length)
+                , m_separator(f_separator)
+            {
+            }
+
+            /** @brief  It reads the next field, the span of the field is returned without the surrounding spaces */
+            inline bool nextField(const char*& f_begin, uint32_t& f_length)
+            {
+                if (m_pos > m_end)
+                {
+                    return false; // the text was consumed, even the empty field after the last separator
+                }
+                const char* l_begin = m_pos;
+                const char* l_end = l_begin;
+                while (l_end < m_end && *l_end != m_separator)
+                {
+                    l_end++;
+                }
+                m_pos = l_end + 1; // after the separator or past the end
+
+                while (l_begin < l_end && isSpace(*l_begin)) l_begin++;
+                while (l_end > l_begin && isSpace(*(l_end - 1))) l_end--;
+                f_begin = l_begin;
+                f_length = (uint32_t)(l_end - l_begin);
+                return true;
+            }
+
+            /** @brief  It reads the next field as an unsigned integer in the [f_min, f_max] range */
+            inline bool next(uint32_t& f_value, uint32_t f_min = 0, uint32_t f_max = UINT32_MAX)
+            {
+                const char* l_field;
+                uint32_t l_length;
+                if (!nextField(l_field, l_length))
+                {
+                    return false;
+                }
+                const char* l_end = l_field + l_length;
+                if (l_field < l_end && *l_field == '+')
+                {
+                    l_field++;
+                }
+                uint32_t l_value;
+                if (!parseDigits(l_field, l_end, l_value) || l_field != l_end || l_value < f_min || l_value > f_max)
+                {
+                    return false;
+                }
+                f_value = l_value;
+                return true;
+            }
+
+            /** @brief  It reads the next field as a signed integer in the [f_min, f_max] range */
+            inline bool next(int32_t& f_value, int32_t f_min = INT32_MIN, int32_t f_max = INT32_MAX)
+            {
+                const char* l_field;
+                uint32_t l_length;
+                if (!nextField(l_field, l_length))
+                {
+                    return false;
+                }
+                const char* l_end = l_field + l_length;
+                bool l_negative = false;
+                if (l_field < l_end && (*l_field == '-' || *l_field == '+'))
+                {
+                    l_negative = (*l_field == '-');
+                    l_field++;
+                }
+                uint32_t l_magnitude;
+                if (!parseDigits(l_field, l_end, l_magnitude) || l_field != l_end)
+                {
+                    return false;
+                }
+                return toSigned(l_magnitude, l_negative, f_min, f_max, f_value);
+            }
+
+            /** @brief  It reads the next field as a decimal number in fixed-point with f_decimals fractional digits ("-1.25" with 
+             * two decimals is -125), the further digits are truncated. The range is given in the same fixed-point scale. */
+            inline bool nextFixed(int32_t& f_value, uint8_t f_decimals, int32_t f_min = INT32_MIN, int32_t f_max = INT32_MAX)
+            {
+                const char* l_field;
+                uint32_t l_length;
+                if (!nextField(l_field, l_length))
+                {
+                    return false;
+                }
+                const char* l_end = l_field + l_length;
+                bool l_negative = false;
+                if (l_field < l_end && (*l_field == '-' || *l_field == '+'))
+                {
+                    l_negative = (*l_field == '-');
+                    l_field++;
+                }
+                uint32_t l_magnitude = 0;
+                bool l_digits = (l_field < l_end && *l_field != '.');
+                if (l_digits && !parseDigits(l_field, l_end, l_magnitude))
+                {
+                    return false;
+                }
+                uint8_t l_fraction = 0;
+                if (l_field < l_end && *l_field == '.')
+                {
+                    l_field++;
+                    while (l_field < l_end && isDigit(*l_field))
+                    {
+                        if (l_fraction < f_decimals)
+                        {
+                            if (!accumulate(l_magnitude, (uint32_t)(*l_field - '0'))) return false;
+                            l_fraction++;
+                        }
+                        l_digits = true;
+                        l_field++;
+                    }
+                }
+                if (!l_digits || l_field != l_end)
+                {
+                    return false;
+                }
+                for (; l_fraction < f_decimals; l_fraction++)
+                {
+                    if (!accumulate(l_magnitude, 0)) return false;
+                }
+                return toSigned(l_magnitude, l_negative, f_min, f_max, f_value);
+            }
+
+            /** @brief  It reads the next field as an integer of the given type, the range is limited to the type */
+            template <typename T>
+            inline bool nextAs(T& f_value, T f_min, T f_max)
+            {
+                return nextInteger(f_value, f_min, f_max, (T)-1 < (T)0);
+            }
+
+            /** @brief  It checks whether all fields were read */
+            inline bool atEnd() const
+            {
+                return m_pos >= m_end;
+            }
+
+        private:
+            template <typename T>
+            inline bool nextInteger(T& f_value, T f_min, T f_max, bool f_signed)
+            {
+                if (f_signed)
+                {
+                    int32_t l_value;
+                    if (!next(l_value, (int32_t)f_min, (int32_t)f_max)) return false;
+                    f_value = (T)l_value;
+                }
+                else
+                {
+                    uint32_t l_value;
+                    if (!next(l_value, (uint32_t)f_min, (uint32_t)f_max)) return false;
+                    f_value = (T)l_value;
+                }
+                return true;
+            }
+
+            static inline bool isDigit(char f_char)
+            {
+                return (f_char >= '0') && (f_char <= '9');
+            }
+
+            static inline bool isSpace(char f_char)
+            {
+                return (f_char == ' ') || (f_char == '\t') || (f_char == '\r') || (f_char == '\n');
+            }
+
+            /** @brief  f_value = f_value * 10 + f_digit, it returns false on overflow */
+            static inline bool accumulate(uint32_t& f_value, uint32_t f_digit)
+            {
+                if (f_value > (UINT32_MAX - f_digit) / 10)
+                {
+                    return false;
+                }
+                f_value = f_value * 10 + f_digit;
+                return true;
+            }
+
+            /** @brief  It reads at least one digit and moves the position after the last digit */
+            static inline bool parseDigits(const char*& f_pos, const char* f_end, uint32_t& f_value)
+            {
+                if (f_pos >= f_end || !isDigit(*f_pos))
+                {
+                    return false;
+                }
+                f_value = 0;
+                while (f_pos < f_end && isDigit(*f_pos))
+                {
+                    if (!accumulate(f_value, (uint32_t)(*f_pos - '0'))) return false;
+                    f_pos++;
+                }
+                return true;
+            }
+
+            static inline bool toSigned(uint32_t f_magnitude, bool f_negative, int32_t f_min, int32_t f_max, int32_t& f_value)
+            {
+                int64_t l_value = f_negative ? -(int64_t)f_magnitude : (int64_t)f_magnitude;
+                if (l_value < f_min || l_value > f_max)
+                {
+                    return false;
+                }
+                f_value = (int32_t)l_value;
+                return true;
+            }
+
+            /** @brief  Start of the next field */
+            const char* m_pos;
+            /** @brief  End of the text */
+            const char* m_end;
+            /** @brief  Separator of the fields */
+            const char m_separator;
+    }; // class CTextParser
+
+}; // namespace utils
+
+#endif // TEXT_PARSER_HPP
\ No newline at end of file
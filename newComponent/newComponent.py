@@ -168,7 +168,7 @@ def create_component(category, component_name, want_serial_callback, project_roo
                 else:
                     lines.insert(i + 1, f'{category}::C{component_name.capitalize()} g_{component_name}(possible_argument);\n')
             
-            if 'CSerialMonitor::CSerialSubscriberMap' in line and want_serial_callback_b:
+            if 'CSerialMonitor::SSubscriber g_serialMonitorSubscribers' in line and want_serial_callback_b:
                 map_start = i
             elif map_start and line.strip() == '};':
                 new_entry = f'    {{"{component_name}", mbed::callback(&g_{component_name}, &{category}::C{component_name.capitalize()}::serialCallback{component_name.capitalize()}Command)}},\n'
@@ -50,9 +50,9 @@ namespace brain
 
     void CBatterymanager::serialCallbackBATTERYCommand(char const * a, char * b) {
         uint16_t l_isActivate=0;
-        uint8_t l_res = sscanf(a,"%hd",&l_isActivate);
+        utils::CTextParser l_parser(a);
 
-        if(1 == l_res){
+        if(l_parser.nextAs<uint16_t>(l_isActivate, 0, UINT16_MAX)){
             uint16_globalsV_battery_mAmps_user = l_isActivate;
             sprintf(b,"ack");
         }else{
@@ -68,7 +68,7 @@ namespace brain
     {
         uint8_t l_keyValue = 0;
 
-        (void)sscanf(a,"%hhu",&l_keyValue);
+        (void)utils::CTextParser(a).nextAs<uint8_t>(l_keyValue, 0, UINT8_MAX);
 
         if(!bool_globalsV_ShuttedDown)
         {
@@ -32,20 +32,21 @@
 #include <brain/robotstatemachine.hpp>
 
 #define scale_ds_to_ms 100
+#define hard_deadline_ms 50
 
 namespace brain{
 
     /**
      * @brief CRobotStateMachine Class constructor
      * 
-     * @param f_period              period for controller execution in seconds
+     * @param f_period              period of the runs without command in milliseconds, the commands run the task by notification
      * @param f_serialPort          reference to serial communication object
      * @param f_steeringControl     reference to steering motor control interface
      * @param f_speedingControl     reference to brushless motor control interface
      */
     CRobotStateMachine::CRobotStateMachine(
             std::chrono::milliseconds                      f_period,
-            UnbufferedSerial&             f_serialPort,
+            drivers::CSerialTransmitter&  f_serialPort,
             drivers::ISteeringCommand&    f_steeringControl,
             drivers::ISpeedingCommand&    f_speedingControl
         ) 
@@ -54,13 +55,20 @@ namespace brain{
         , m_steeringControl(f_steeringControl)
         , m_speedingControl(f_speedingControl)
         , m_state(0)
-        , m_ticksRun(0)
+        , m_pending(0)
+        , m_startTime(0)
         , m_targetTime(0)
-        , m_period((uint16_t)(f_period.count()))
+        , m_idlePeriod((uint16_t)(f_period.count()))
         , m_speed(0)
         , m_steering(0)
         , m_calibON(false)
+        , m_requests()
+        , m_replies()
     {
+        // The runs apply the latest commands and the timed movement (vcd) is measured on the clock, so the missed activations are skipped.
+        setOverrunPolicy(SKIP);
+        // The received commands have to be applied in time, a late run is reported as a hard deadline miss (from the notification).
+        setHardDeadline(std::chrono::milliseconds(hard_deadline_ms));
     }
 
     /** @brief  CRobotStateMachine class destructor
@@ -70,64 +78,88 @@ namespace brain{
     };
 
     /** \brief  _Run method contains the main application logic, where it controls the lower lever drivers (dc motor and steering) based the given command and state.
-     * It has three main states: 
-     *  - 1 - move state -> control the motor rotation speed by giving a speed reference, which is then converted to PWM
-     *  - 2 - steering state -> trigger the steering of the motor
-     *  - 3 - Brake state -> make the motor enter into a brake state. 
+     * The commands received since the last run are applied together, in one run, so a speed and a steering command sent in one message 
+     * don't overwrite each other. Their confirmations are sent in one line, e.g. "@speed:100;;|steer:50;;\r\n", each one with the 
+     * value of its own command, captured when the command was received:
+     *  - speed -> control the motor rotation speed by giving a speed reference, which is then converted to PWM
+     *  - steer -> trigger the steering of the motor
+     *  - brake -> make the motor enter into a brake state. 
+     * The task is run by the commands' notifications, it has no periodic work. The period given in the constructor is kept, 
+     * while there is no timed movement. The timed movement sets the period to the remaining time, so the task wakes up at its end.
+     * The state machine has one state:
      *  - 4 - State responsible for configuring the vehicle's speed and steering over a specified duration.         
      */
     void CRobotStateMachine::_run()
     {   
-        char buffer[100];
-        switch(m_state)
+        if (m_pending != 0)
         {
-            // speed state - control the dc motor rotation speed and the steering angle. 
-            case 1:
-                m_speedingControl.setSpeed(m_speed); // Set the reference speed
-                snprintf(buffer, sizeof(buffer), "@speed:%d;;\r\n", m_speed);
-                m_serialPort.write(buffer, strlen(buffer));
-                m_state = 0;
-                break;
+            char buffer[200];
+            utils::CTextFormatter l_text(buffer, sizeof(buffer));
+            uint8_t l_source = drivers::CSerialTransmitter::ID_TEXT;
 
-            // Steering state
-            case 2:
+            if (m_pending & ((1 << PENDING_STEER) | (1 << PENDING_BRAKE)))
+            {
                 m_steeringControl.setAngle(m_steering); // control the steering angle
-                snprintf(buffer, sizeof(buffer), "@steer:%d;;\r\n", m_steering);
-                m_serialPort.write(buffer, strlen(buffer));
-                m_state = 0;
-                break;
-
-            // Brake state
-            case 3:
-                m_steeringControl.setAngle(m_steering); // control the steering angle 
+            }
+            if (m_pending & (1 << PENDING_SPEED))
+            {
+                m_speedingControl.setSpeed(m_speed); // Set the reference speed
+                l_source = drivers::CSerialTransmitter::ID_SPEED;
+                l_text.append("@speed");
+                drivers::CSerialMonitor::appendStamp(l_text, m_requests[PENDING_SPEED], us_ticker_read()); // T_DONE is the time of the actuation
+                l_text.appendChar(':').appendSigned(m_replies[PENDING_SPEED]).append(";;");
+            }
+            if (m_pending & (1 << PENDING_STEER))
+            {
+                if (l_text.length() == 0) l_source = drivers::CSerialTransmitter::ID_STEER;
+                l_text.appendChar((l_text.length() == 0) ? '@' : '|').append("steer");
+                drivers::CSerialMonitor::appendStamp(l_text, m_requests[PENDING_STEER], us_ticker_read());
+                l_text.appendChar(':').appendSigned(m_replies[PENDING_STEER]).append(";;");
+            }
+            if (m_pending & (1 << PENDING_BRAKE))
+            {
                 m_speedingControl.setBrake();
-                snprintf(buffer, sizeof(buffer), "@brake:1;;\r\n");
-                m_serialPort.write(buffer, strlen(buffer));
-                m_state = 0;
-                break;
+                if (l_text.length() == 0) l_source = drivers::CSerialTransmitter::ID_BRAKE;
+                l_text.appendChar((l_text.length() == 0) ? '@' : '|').append("brake");
+                drivers::CSerialMonitor::appendStamp(l_text, m_requests[PENDING_BRAKE], us_ticker_read());
+                l_text.append(":1;;");
+            }
+            l_text.append("\r\n");
+            m_serialPort.write(buffer, l_text.length(), l_source);
+            m_pending = 0;
+        }
 
+        switch(m_state)
+        {
             // State responsible for configuring the vehicle's speed and steering over a specified duration.
             case 4:
-                // If the accumulated ticks exceed the target time, stop the movement and deactivate the task.
-                if(m_ticksRun >= m_targetTime+m_period)
+            {
+                uint32_t l_elapsed = (us_ticker_read() - m_startTime) / 1000;
+                // If the elapsed time exceeds the target time, stop the movement and deactivate the task.
+                if(l_elapsed >= m_targetTime)
                 {
                     m_speedingControl.setSpeed(0);
                     m_steeringControl.setAngle(0);
                     m_state = 0;
 
-                    if(!m_calibON) m_serialPort.write("@vcd:0;0;0;;\r\n", 15);
+                    if(!m_calibON) m_serialPort.write("@vcd:0;0;0;;\r\n", 15, drivers::CSerialTransmitter::ID_VCD);
                     else{
-                       m_serialPort.write("@vcdCalib:0;0;;\r\n", 18);
+                       m_serialPort.write("@vcdCalib:0;0;;\r\n", 18, drivers::CSerialTransmitter::ID_VCD_CALIB);
                        m_calibON = false;
                     } 
-                    
+                    setNewPeriod(m_idlePeriod);
                 }
                 else
                 {
-                    // Otherwise, increment the tick counter.
-                    m_ticksRun += m_period;
+                    // Otherwise, wake up at the end of the movement.
+                    setNewPeriod((uint16_t)(m_targetTime - l_elapsed));
                 }
                 break;
+            }
+            default:
+                // A command has cancelled the timed movement
+                if((uint16_t)CTask::m_period.count() != m_idlePeriod) setNewPeriod(m_idlePeriod);
+                break;
         }
     }
 
@@ -143,9 +175,9 @@ namespace brain{
      */
     void CRobotStateMachine::serialCallbackSPEEDcommand(char const * a, char * b)
     {
-        int l_speed;
-        uint32_t l_res = sscanf(a,"%d",&l_speed);
-        if (1 == l_res)
+        int32_t l_speed;
+        utils::CTextParser l_parser(a);
+        if (l_parser.next(l_speed))
         {
             if(uint8_globalsV_value_of_kl == 30)
             {
@@ -158,8 +190,12 @@ namespace brain{
 
                 // m_speed = l_speed;
 
-                m_state = 1;
+                m_state = 0;
+                m_pending = (m_pending & ~(1 << PENDING_BRAKE)) | (1 << PENDING_SPEED); // the later command wins
                 m_speed = m_speedingControl.inRange(l_speed);
+                m_requests[PENDING_SPEED] = drivers::CSerialMonitor::currentRequest();
+                m_replies[PENDING_SPEED] = m_speed;
+                notify();
 
             }
             else{
@@ -183,9 +219,9 @@ namespace brain{
      */
     void CRobotStateMachine::serialCallbackSTEERcommand(char const * a, char * b)
     {
-        int l_angle;
-        uint32_t l_res = sscanf(a,"%d",&l_angle);
-        if (1 == l_res)
+        int32_t l_angle;
+        utils::CTextParser l_parser(a);
+        if (l_parser.next(l_angle))
         {
             if(uint8_globalsV_value_of_kl == 30)
             {
@@ -198,8 +234,12 @@ namespace brain{
 
                 // m_steering = l_angle;
 
-                m_state = 2;
+                m_state = 0;
+                m_pending |= (1 << PENDING_STEER);
                 m_steering = m_steeringControl.inRange(l_angle);
+                m_requests[PENDING_STEER] = drivers::CSerialMonitor::currentRequest();
+                m_replies[PENDING_STEER] = m_steering; // a later brake in the same message changes m_steering
+                notify();
             }
             else{
                 sprintf(b,"kl 30 is required!!");
@@ -221,9 +261,9 @@ namespace brain{
      */
     void CRobotStateMachine::serialCallbackBRAKEcommand(char const * a, char * b)
     {
-        int l_angle;
-        uint32_t l_res = sscanf(a,"%d",&l_angle);
-        if(1 == l_res)
+        int32_t l_angle;
+        utils::CTextParser l_parser(a);
+        if(l_parser.next(l_angle))
         {
             // if(!m_steeringControl.inRange(l_angle)){
             //     sprintf(b,"The steering angle command is too high/low");
@@ -234,8 +274,11 @@ namespace brain{
 
             // m_steering = l_angle;
             
-            m_state = 3;
+            m_state = 0;
+            m_pending = (m_pending & ~(1 << PENDING_SPEED)) | (1 << PENDING_BRAKE); // the later command wins
             m_steering = m_steeringControl.inRange(l_angle);
+            m_requests[PENDING_BRAKE] = drivers::CSerialMonitor::currentRequest();
+            notify();
 
         }
         else
@@ -254,10 +297,11 @@ namespace brain{
      */
     void CRobotStateMachine::serialCallbackVCDcommand(char const * message, char * response)
     {
-        int speed, steer;
-        uint8_t time_deciseconds;
+        int32_t speed = 0, steer = 0;
+        uint8_t time_deciseconds = 0;
 
-        uint8_t parsed = sscanf(message, "%d;%d;%hhu", &speed, &steer, &time_deciseconds);
+        utils::CTextParser l_parser(message);
+        bool parsed = l_parser.next(speed) && l_parser.next(steer) && l_parser.nextAs<uint8_t>(time_deciseconds, 0, UINT8_MAX);
 
         if(uint8_globalsV_value_of_kl != 30){
             sprintf(response,"kl 30 is required!!");
@@ -266,15 +310,17 @@ namespace brain{
 
         m_targetTime = time_deciseconds;
 
-        if(parsed == 3 && speed < 501 && speed > -501 && steer < 233 && steer > -233)
+        if(parsed && speed < 501 && speed > -501 && steer < 233 && steer > -233)
         {
-            sprintf(response, "%d;%d;%d", speed, steer, time_deciseconds);
+            sprintf(response, "%d;%d;%d", (int)speed, (int)steer, time_deciseconds);
 
-            m_ticksRun = 0;
+            m_startTime = us_ticker_read();
 
             m_targetTime = time_deciseconds * scale_ds_to_ms;
 
             m_state = 4;
+            m_pending = 0; // the later command wins
+            setNewPeriod((m_targetTime > 0) ? m_targetTime : 1); // the task wakes up at the end of the movement
 
             m_steeringControl.setAngle(steer);
             m_speedingControl.setSpeed(speed);
@@ -295,10 +341,11 @@ namespace brain{
      */
     void CRobotStateMachine::serialCallbackVCDCalibcommand(char const * message, char * response)
     {
-        int speed, steer;
-        uint8_t time_deciseconds;
+        int32_t speed = 0, steer = 0;
+        uint8_t time_deciseconds = 0;
 
-        uint8_t parsed = sscanf(message, "%d;%d;%hhu", &speed, &steer, &time_deciseconds);
+        utils::CTextParser l_parser(message);
+        bool parsed = l_parser.next(speed) && l_parser.next(steer) && l_parser.nextAs<uint8_t>(time_deciseconds, 0, UINT8_MAX);
 
         if(uint8_globalsV_value_of_kl != 30){
             sprintf(response,"kl 30 is required!!");
@@ -307,13 +354,15 @@ namespace brain{
 
         m_targetTime = time_deciseconds;
 
-        if(parsed == 3 && speed < 501 && speed > -501 && steer < 273 && steer > -273)
+        if(parsed && speed < 501 && speed > -501 && steer < 273 && steer > -273)
         {
-            m_ticksRun = 0;
+            m_startTime = us_ticker_read();
 
             m_targetTime = time_deciseconds * scale_ds_to_ms;
 
             m_state = 4;
+            m_pending = 0; // the later command wins
+            setNewPeriod((m_targetTime > 0) ? m_targetTime : 1); // the task wakes up at the end of the movement
 
             m_steeringControl.setAngle(steer);
             m_speedingControl.setSpeed(speed);
@@ -332,7 +381,7 @@ namespace brain{
     {
         uint8_t msg = 0;
 
-        (void)sscanf(message,"%hhu",&msg);
+        (void)utils::CTextParser(message).nextAs<uint8_t>(msg, 0, UINT8_MAX);
 
         sprintf(response, "%d;%d", m_steeringControl.get_lower_limit(), m_steeringControl.get_upper_limit());
     }
@@ -341,8 +390,9 @@ namespace brain{
     {
         uint8_t alive = 0;
 
-        (void)sscanf(message,"%hhu",&alive);
+        (void)utils::CTextParser(message).nextAs<uint8_t>(alive, 0, UINT8_MAX);
 
+        notify(); // the state machine runs for each keep-alive, so its start latency is measured also without motion commands
         sprintf(response,"1");
     }
 
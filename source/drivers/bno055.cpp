@@ -2795,6 +2795,35 @@ BNO055_RETURN_FUNCTION_TYPE bno055_read_gravity_xyz(struct bno055_gravity_t *gra
     return com_rslt;
 }
 
+/*!
+ *  @brief This API decodes the fusion data block read from
+ *  register 0x1A to 0x33 (e.g. by an asynchronous bus read)
+ *
+ *
+ *  @param data_u8 : The twenty six bytes of the block
+ *  @param fusion : The value of the fusion data's
+ *
+ */
+void bno055_decode_fusion_data(const u8 *data_u8, struct bno055_fusion_t *fusion)
+{
+    /* The words of the block in the order of the registers*/
+    s16 *words_s16[BNO055_FUSION_DATA_SIZE / 2] = {
+        &fusion->euler.h, &fusion->euler.r, &fusion->euler.p,
+        &fusion->quaternion.w, &fusion->quaternion.x, &fusion->quaternion.y, &fusion->quaternion.z,
+        &fusion->linear_accel.x, &fusion->linear_accel.y, &fusion->linear_accel.z,
+        &fusion->gravity.x, &fusion->gravity.y, &fusion->gravity.z
+    };
+    u8 index_u8 = BNO055_INIT_VALUE;
+
+    /* Decode the little endian words in place*/
+    for (index_u8 = BNO055_INIT_VALUE; index_u8 < BNO055_FUSION_DATA_SIZE / 2; index_u8++)
+    {
+        *words_s16[index_u8] =
+            (s16)((((s32)((s8)data_u8[2 * index_u8 + 1])) << BNO055_SHIFT_EIGHT_BITS) |
+                  (data_u8[2 * index_u8]));
+    }
+}
+
 /*!
  *  @brief This API reads temperature values
  *  from register 0x33 it is a byte data
@@ -0,0 +1,284 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+#include <drivers/bno055shadow.hpp>
+
+namespace drivers{
+
+    CBno055Shadow::FBus CBno055Shadow::s_write = nullptr;
+    CBno055Shadow::FBus CBno055Shadow::s_read = nullptr;
+    u8 CBno055Shadow::s_page = BNO055_PAGE_ZERO;
+    bool CBno055Shadow::s_pageValid = false;
+    u8 CBno055Shadow::s_values[bno055_shadow_pages][bno055_shadow_registers] = {};
+    uint32_t CBno055Shadow::s_valid[bno055_shadow_pages][bno055_shadow_registers / 32] = {};
+    CBno055Shadow::SStats CBno055Shadow::s_stats = {};
+
+    /** @brief  Sets the functions accessing the bus
+     *
+     *  The state of the sensor is unknown, so the copy is dropped.
+     *
+     *  @param f_write          function writing on the bus
+     *  @param f_read           function reading from the bus
+     */
+    void CBno055Shadow::attach(FBus f_write, FBus f_read)
+    {
+        s_write = f_write;
+        s_read = f_read;
+        invalidate();
+    }
+
+    /** @brief  Drops the copy of the registers and the selected page
+     */
+    void CBno055Shadow::invalidate()
+    {
+        s_pageValid = false;
+        invalidatePage(BNO055_PAGE_ZERO);
+        invalidatePage(BNO055_PAGE_ONE);
+    }
+
+    /** @brief  Clears the statistics
+     */
+    void CBno055Shadow::resetStats()
+    {
+        s_stats.reads = 0;
+        s_stats.writes = 0;
+        s_stats.cachedReads = 0;
+        s_stats.skippedWrites = 0;
+    }
+
+    /** @brief  The register of the selected page is kept in the copy
+     *
+     *  @param f_register       address of the register
+     */
+    bool CBno055Shadow::isShadowed(u8 f_register)
+    {
+        if(s_page == BNO055_PAGE_ZERO)
+        {
+            switch(f_register)
+            {
+                case BNO055_CHIP_ID_ADDR:
+                case BNO055_ACCEL_REV_ID_ADDR:
+                case BNO055_MAG_REV_ID_ADDR:
+                case BNO055_GYRO_REV_ID_ADDR:
+                case BNO055_SW_REV_ID_LSB_ADDR:
+                case BNO055_SW_REV_ID_MSB_ADDR:
+                case BNO055_BL_REV_ID_ADDR:
+                case BNO055_UNIT_SEL_ADDR:
+                case BNO055_OPR_MODE_ADDR:
+                case BNO055_PWR_MODE_ADDR:
+                case BNO055_TEMP_SOURCE_ADDR:
+                case BNO055_AXIS_MAP_CONFIG_ADDR:
+                case BNO055_AXIS_MAP_SIGN_ADDR:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+        // The configurations of the page one are changed by the sensor in the fusion modes
+        return (f_register >= BNO055_ACCEL_CONFIG_ADDR) && (f_register <= BNO055_GYRO_ANY_MOTION_SET_ADDR) && isConfigMode();
+    }
+
+    /** @brief  The sensor is in config mode, it's false when the operation mode is unknown
+     */
+    bool CBno055Shadow::isConfigMode()
+    {
+        return ((s_valid[BNO055_PAGE_ZERO][BNO055_OPR_MODE_ADDR / 32] >> (BNO055_OPR_MODE_ADDR % 32)) & 1U)
+            && ((s_values[BNO055_PAGE_ZERO][BNO055_OPR_MODE_ADDR] & BNO055_OPERATION_MODE_MSK) == BNO055_OPERATION_MODE_CONFIG);
+    }
+
+    /** @brief  Drops the copy of the registers of a page
+     *
+     *  @param f_page           page of the registers
+     */
+    void CBno055Shadow::invalidatePage(u8 f_page)
+    {
+        for(uint8_t l_word = 0; l_word < bno055_shadow_registers / 32; ++l_word)
+        {
+            s_valid[f_page][l_word] = 0;
+        }
+    }
+
+    /** @brief  Drops the copy of a register, the copy of the page one is dropped with the operation mode
+     *
+     *  @param f_page           page of the register
+     *  @param f_register       address of the register
+     */
+    void CBno055Shadow::invalidateRegister(u8 f_page, u8 f_register)
+    {
+        s_valid[f_page][f_register / 32] &= ~(1UL << (f_register % 32));
+        if((f_page == BNO055_PAGE_ZERO) && (f_register == BNO055_OPR_MODE_ADDR))
+        {
+            invalidatePage(BNO055_PAGE_ONE);
+        }
+    }
+
+    /** @brief  Bus read function for the driver
+     *
+     *  The read is served from the copy when all the registers are kept and valid, otherwise it's made on the bus and 
+     *  the kept registers are updated.
+     *
+     *  @param dev_addr         address of the sensor
+     *  @param reg_addr         address of the first register
+     *  @param reg_data         read values
+     *  @param cnt              number of registers
+     *  @return                 BNO055_SUCCESS or BNO055_ERROR
+     */
+    s8 CBno055Shadow::busRead(u8 dev_addr, u8 reg_addr, u8 *reg_data, u8 cnt)
+    {
+        if(s_read == nullptr) return BNO055_ERROR;
+
+        if(s_pageValid && (reg_addr == BNO055_PAGE_ID_ADDR) && (cnt == 1))
+        {
+            reg_data[0] = s_page;
+            s_stats.cachedReads++;
+            return BNO055_SUCCESS;
+        }
+
+        bool l_cached = s_pageValid && ((uint16_t)reg_addr + cnt <= bno055_shadow_registers);
+        for(u8 l_index = 0; l_cached && (l_index < cnt); ++l_index)
+        {
+            u8 l_register = reg_addr + l_index;
+            l_cached = isShadowed(l_register) && ((s_valid[s_page][l_register / 32] >> (l_register % 32)) & 1U);
+        }
+        if(l_cached)
+        {
+            for(u8 l_index = 0; l_index < cnt; ++l_index)
+            {
+                reg_data[l_index] = s_values[s_page][reg_addr + l_index];
+            }
+            s_stats.cachedReads++;
+            return BNO055_SUCCESS;
+        }
+
+        s_stats.reads++;
+        s8 l_result = s_read(dev_addr, reg_addr, reg_data, cnt);
+        if(l_result != BNO055_SUCCESS) return l_result;
+
+        if((reg_addr == BNO055_PAGE_ID_ADDR) && (cnt == 1))
+        {
+            s_page = reg_data[0] & BNO055_PAGE_ONE;
+            s_pageValid = true;
+        }
+        else if(s_pageValid)
+        {
+            for(u8 l_index = 0; (l_index < cnt) && ((uint16_t)reg_addr + l_index < bno055_shadow_registers); ++l_index)
+            {
+                u8 l_register = reg_addr + l_index;
+                if(isShadowed(l_register))
+                {
+                    s_values[s_page][l_register] = reg_data[l_index];
+                    s_valid[s_page][l_register / 32] |= 1UL << (l_register % 32);
+                }
+            }
+        }
+        return l_result;
+    }
+
+    /** @brief  Bus write function for the driver
+     *
+     *  The write of the selected page and the write of unchanged values in config mode (or of the unchanged operation mode) 
+     *  are skipped. The writes of the configuration registers outside the config mode can be ignored by the sensor, so they 
+     *  drop the copy of the registers.
+     *
+     *  @param dev_addr         address of the sensor
+     *  @param reg_addr         address of the first register
+     *  @param reg_data         values to write
+     *  @param cnt              number of registers
+     *  @return                 BNO055_SUCCESS or BNO055_ERROR
+     */
+    s8 CBno055Shadow::busWrite(u8 dev_addr, u8 reg_addr, u8 *reg_data, u8 cnt)
+    {
+        if(s_write == nullptr) return BNO055_ERROR;
+
+        if((reg_addr == BNO055_PAGE_ID_ADDR) && (cnt == 1))
+        {
+            if(s_pageValid && (s_page == reg_data[0]))
+            {
+                s_stats.skippedWrites++;
+                return BNO055_SUCCESS;
+            }
+            s_stats.writes++;
+            s8 l_result = s_write(dev_addr, reg_addr, reg_data, cnt);
+            s_page = reg_data[0] & BNO055_PAGE_ONE;
+            s_pageValid = (l_result == BNO055_SUCCESS);
+            return l_result;
+        }
+
+        // The registers of an unknown page can't be followed
+        if(!s_pageValid || ((uint16_t)reg_addr + cnt > bno055_shadow_registers))
+        {
+            invalidate();
+            s_stats.writes++;
+            return s_write(dev_addr, reg_addr, reg_data, cnt);
+        }
+
+        const bool l_configMode = isConfigMode();
+        bool l_skip = true;
+        for(u8 l_index = 0; l_skip && (l_index < cnt); ++l_index)
+        {
+            u8 l_register = reg_addr + l_index;
+            l_skip = isShadowed(l_register) && ((s_valid[s_page][l_register / 32] >> (l_register % 32)) & 1U)
+                  && (s_values[s_page][l_register] == reg_data[l_index])
+                  && (l_configMode || ((s_page == BNO055_PAGE_ZERO) && (l_register == BNO055_OPR_MODE_ADDR)));
+        }
+        if(l_skip)
+        {
+            s_stats.skippedWrites++;
+            return BNO055_SUCCESS;
+        }
+
+        s_stats.writes++;
+        s8 l_result = s_write(dev_addr, reg_addr, reg_data, cnt);
+        for(u8 l_index = 0; l_index < cnt; ++l_index)
+        {
+            u8 l_register = reg_addr + l_index;
+            bool l_opMode = (s_page == BNO055_PAGE_ZERO) && (l_register == BNO055_OPR_MODE_ADDR);
+            if((l_result == BNO055_SUCCESS) && (l_opMode || (l_configMode && isShadowed(l_register))))
+            {
+                s_values[s_page][l_register] = reg_data[l_index];
+                s_valid[s_page][l_register / 32] |= 1UL << (l_register % 32);
+                if(l_opMode && !isConfigMode()) invalidatePage(BNO055_PAGE_ONE); // leaves the config mode
+            }
+            else
+            {
+                invalidateRegister(s_page, l_register);
+            }
+
+            // The reset restores the registers and the page zero
+            if((s_page == BNO055_PAGE_ZERO) && (l_register == BNO055_SYS_TRIGGER_ADDR) && (reg_data[l_index] & BNO055_SYS_RST_MSK))
+            {
+                invalidate();
+                break;
+            }
+        }
+        return l_result;
+    }
+
+}; // namespace drivers
\ No newline at end of file
@@ -0,0 +1,207 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+#include <drivers/i2cengine.hpp>
+
+#define i2c_timeout_us 10000
+#define i2c_error_events (I2C_EVENT_ERROR | I2C_EVENT_ERROR_NO_SLAVE | I2C_EVENT_TRANSFER_EARLY_NACK)
+
+namespace drivers{
+
+    /** @brief  CI2CEngine class constructor
+     *
+     *  @param f_sda            data pin of the bus
+     *  @param f_scl            clock pin of the bus
+     *  @param f_frequency      frequency of the bus in Hz
+     *  @param f_wakeup         callback applied from interrupt context after the completion of a transaction
+     */
+    CI2CEngine::CI2CEngine(
+            PinName f_sda,
+            PinName f_scl,
+            uint32_t f_frequency,
+            mbed::Callback<void()> f_wakeup)
+        : m_bus(f_sda, f_scl)
+        , m_wakeup(f_wakeup)
+        , m_queue()
+        , m_busy(false)
+        , m_completed(false)
+        , m_event(0)
+        , m_startTime(0)
+        , m_stats()
+    {
+        m_bus.frequency(f_frequency);
+    }
+
+    /** @brief  CI2CEngine class destructor
+     */
+    CI2CEngine::~CI2CEngine()
+    {
+#if I2C_ENGINE_ASYNCH
+        if (m_busy) m_bus.abort_transfer();
+#endif
+    };
+
+    /** @brief  Queues a transaction
+     *
+     *  The written bytes are copied, the read buffer has to be kept until the completion. The transaction is started at once, 
+     *  when the bus is free.
+     *
+     *  @param f_address        8-bit address of the device
+     *  @param f_tx             bytes to write (e.g. the register address)
+     *  @param f_txLength       number of the bytes to write, at most i2c_max_tx
+     *  @param f_rx             buffer of the read bytes
+     *  @param f_rxLength       number of the bytes to read, zero for write only transaction
+     *  @param f_done           completion callback, applied from task context by process
+     *  @return                 false, when the queue is full or the transaction is too long
+     */
+    bool CI2CEngine::submit(uint8_t f_address, const uint8_t* f_tx, uint8_t f_txLength, uint8_t* f_rx, uint8_t f_rxLength, FDone f_done)
+    {
+        if ((f_txLength > i2c_max_tx) || m_queue.isFull()) return false;
+
+        STransaction l_transaction;
+        l_transaction.address = f_address;
+        memcpy(l_transaction.tx, f_tx, f_txLength);
+        l_transaction.txLength = f_txLength;
+        l_transaction.rx = f_rx;
+        l_transaction.rxLength = f_rxLength;
+        l_transaction.done = f_done;
+        l_transaction.submitTime = us_ticker_read();
+        m_queue.push(l_transaction);
+
+        if (!m_busy) start();
+        return true;
+    }
+
+    /** @brief  Completes the finished transaction and starts the next one
+     *
+     *  It has to be applied from task context, after the wakeup callback and periodically (for the timeout). The completion 
+     *  callback of the transaction is applied here.
+     *
+     *  @return                 true, when a transaction was completed
+     */
+    bool CI2CEngine::process()
+    {
+        bool l_completed = false;
+        if (m_busy)
+        {
+            if (m_completed)
+            {
+                int l_event = m_event;
+                finish(((l_event & I2C_EVENT_TRANSFER_COMPLETE) && !(l_event & i2c_error_events)) ? 0 : -1);
+                l_completed = true;
+            }
+            else if (us_ticker_read() - m_startTime > i2c_timeout_us)
+            {
+#if I2C_ENGINE_ASYNCH
+                m_bus.abort_transfer();
+#endif
+                finish(-1);
+                l_completed = true;
+            }
+        }
+        if (!m_busy && !m_queue.isEmpty()) start();
+        return l_completed;
+    }
+
+    /** @brief  Clears the statistics */
+    void CI2CEngine::resetStats()
+    {
+        m_stats.count = 0;
+        m_stats.errors = 0;
+        m_stats.latencyLast = 0;
+        m_stats.latencyMax = 0;
+        m_stats.latencySum = 0;
+    }
+
+    /** @brief  Starts the first queued transaction
+     *
+     *  The write and the read are made in one transfer with repeated start. Without asynchronous I2C the transfer is blocking.
+     */
+    void CI2CEngine::start()
+    {
+        const STransaction* l_transaction;
+        if (0 == m_queue.peek(l_transaction)) return;
+
+        m_busy = true;
+        m_completed = false;
+        m_startTime = us_ticker_read();
+#if I2C_ENGINE_ASYNCH
+        if (m_bus.transfer(l_transaction->address, (const char*)l_transaction->tx, l_transaction->txLength, (char*)l_transaction->rx, 
+                           l_transaction->rxLength, mbed::callback(this, &CI2CEngine::transferCallback), I2C_EVENT_ALL) != 0)
+        {
+            finish(-1); // The peripheral is used by other transfer
+        }
+#else
+        bool l_read = (l_transaction->rxLength > 0);
+        int l_error = m_bus.write(l_transaction->address, (const char*)l_transaction->tx, l_transaction->txLength, l_read);
+        if ((0 == l_error) && l_read) l_error = m_bus.read(l_transaction->address, (char*)l_transaction->rx, l_transaction->rxLength);
+        m_event = (0 == l_error) ? I2C_EVENT_TRANSFER_COMPLETE : I2C_EVENT_ERROR;
+        m_completed = true;
+        if (m_wakeup) m_wakeup();
+#endif
+    }
+
+    /** @brief  Completes the transaction in progress
+     *
+     *  It records the latency and applies the completion callback of the transaction.
+     *
+     *  @param f_result         zero for success, negative for error
+     */
+    void CI2CEngine::finish(int f_result)
+    {
+        STransaction l_transaction;
+        m_queue.pop(l_transaction);
+        m_busy = false;
+        m_completed = false;
+
+        uint32_t l_latency = us_ticker_read() - l_transaction.submitTime;
+        m_stats.count++;
+        if (f_result != 0) m_stats.errors++;
+        m_stats.latencyLast = l_latency;
+        if (l_latency > m_stats.latencyMax) m_stats.latencyMax = l_latency;
+        m_stats.latencySum += l_latency;
+
+        if (l_transaction.done) l_transaction.done(f_result);
+    }
+
+    /** @brief  Transfer callback
+     *
+     *  It's applied from interrupt context at the end of the transfer, it marks the completion and wakes up the user of the engine.
+     *
+     *  @param f_event          events of the transfer
+     */
+    void CI2CEngine::transferCallback(int f_event)
+    {
+        m_event = f_event;
+        m_completed = true;
+        if (m_wakeup) m_wakeup();
+    }
+
+}; // namespace drivers
\ No newline at end of file
@@ -31,27 +31,64 @@
 
 #include <drivers/serialmonitor.hpp>
 
+#define rx_budget 128 // maximum number of characters processed in one run
+#define empty_slot 0xFF
+#define bits_per_character 10 // start bit, 8 data bits and stop bit
+#define max_frame_commands 8 // maximum number of the commands in one message
+#define max_stamp_chars 44 // length of the "/SEQ/T_RX/T_DISPATCH/T_DONE" extension
+#define baud_verify_timeout std::chrono::milliseconds(1000) // time for receiving a valid message after the switch of the baud rate
+
 namespace drivers{
 
+    CSerialMonitor::SRequestStamp CSerialMonitor::s_request = {false, 0, 0, 0};
+
     /** @brief  CSerialMonitor class constructor
      *
+     *  It builds the hash table of the subscribers' keys. If more subscribers have the same key, the first one is applied.
      *
      *  @param f_serialPort               reference to serial object
-     *  @param f_serialSubscriberMap      map with the key and the callback functions
+     *  @param f_serialTx                 reference to the transmitter of the responses
+     *  @param f_subscribers              array with the keys and the callback functions
+     *  @param f_subscriberCount          number of subscribers, at most the half of subscriber_table_size
+     *  @param f_baudRate                 initial baud rate of the serial port
      */
     CSerialMonitor::CSerialMonitor(
             UnbufferedSerial& f_serialPort,
-            CSerialSubscriberMap f_serialSubscriberMap)
+            CSerialTransmitter& f_serialTx,
+            const SSubscriber* f_subscribers,
+            uint8_t f_subscriberCount,
+            uint32_t f_baudRate)
         :utils::CTask(std::chrono::milliseconds(0))
-        , m_serialPort(f_serialPort)
-        , m_RxBuffer()
-        , m_TxBuffer()
+        , m_receiver(f_serialPort, mbed::callback(this,&CSerialMonitor::serialRxCallback))
+        , m_serialTx(f_serialTx)
         , m_parseBuffer()
-        , m_parseIt(m_parseBuffer.begin())
-        , m_serialSubscriberMap(f_serialSubscriberMap) 
+        , m_parseIt(m_parseBuffer.end()) // waiting for the first '#'
+        , m_subscribers(f_subscribers)
+        , m_modeRequest(-1)
+        , m_serialPort(f_serialPort)
+        , m_baudRate(f_baudRate)
+        , m_baudFallback(f_baudRate)
+        , m_baudRequest(f_baudRate)
+        , m_baudState(BAUD_IDLE)
+        , m_baudTimerExpired(false)
+        , m_baudTimer()
+        , m_rxTime(0)
+        , m_messageRxTime(0)
         {
-            m_serialPort.attach(mbed::callback(this,&CSerialMonitor::serialRxCallback), SerialBase::RxIrq); 
-            // m_serialPort.attach(mbed::callback(this,&CSerialMonitor::serialTxCallback), SerialBase::TxIrq);
+            memset(m_subscriberTable, empty_slot, sizeof(m_subscriberTable));
+            memset(m_idTable, empty_slot, sizeof(m_idTable));
+            for (uint8_t i = 0; (i < f_subscriberCount) && (i < subscriber_table_size - 1); i++)
+            {
+                uint32_t l_slot = hashKey(f_subscribers[i].key) & (subscriber_table_size - 1);
+                while ((m_subscriberTable[l_slot] != empty_slot) && (strcmp(f_subscribers[m_subscriberTable[l_slot]].key, f_subscribers[i].key) != 0))
+                {
+                    l_slot = (l_slot + 1) & (subscriber_table_size - 1);
+                }
+                if (m_subscriberTable[l_slot] == empty_slot) m_subscriberTable[l_slot] = i;
+
+                uint8_t l_id = f_subscribers[i].id;
+                if ((l_id != CSerialTransmitter::ID_TEXT) && (l_id < subscriber_table_size) && (m_idTable[l_id] == empty_slot)) m_idTable[l_id] = i;
+            }
         }
 
     /** @brief  CSerialMonitor class destructor
@@ -60,96 +97,433 @@ namespace drivers{
     {
     };
 
+    /** @brief  Serial callback for selecting the binary mode
+     *
+     *  The mode is changed after the response was sent, the response is sent in the mode of the request.
+     *
+     *  @param a     1 for binary mode, 0 for text mode
+     *  @param b     response
+     */
+    void CSerialMonitor::serialCallbackBINARYcommand(char const * a, char * b)
+    {
+        uint8_t l_binary = 0;
+        utils::CTextParser l_parser(a);
+        if (l_parser.nextAs<uint8_t>(l_binary, 0, 1))
+        {
+            m_modeRequest = l_binary;
+            sprintf(b,"%d",l_binary);
+        }
+        else
+        {
+            sprintf(b,"syntax error");
+        }
+    }
+
+    /** @brief  Serial callback for changing the baud rate
+     *
+     *  The rate is changed after the response was sent at the old rate, see the negotiation in the description of the class. 
+     *  The supported rates are 115200, 230400, 460800, 921600, 1000000 and 2000000.
+     *
+     *  @param a     new baud rate
+     *  @param b     response, the accepted baud rate
+     */
+    void CSerialMonitor::serialCallbackBAUDcommand(char const * a, char * b)
+    {
+        static const uint32_t l_supported[] = {115200, 230400, 460800, 921600, 1000000, 2000000};
+
+        uint32_t l_baudRate = 0;
+        utils::CTextParser l_parser(a);
+        if (!l_parser.next(l_baudRate))
+        {
+            sprintf(b,"syntax error");
+            return;
+        }
+        bool l_valid = false;
+        for (uint8_t i = 0; i < sizeof(l_supported) / sizeof(l_supported[0]); i++)
+        {
+            if (l_supported[i] == l_baudRate) l_valid = true;
+        }
+        if (!l_valid)
+        {
+            sprintf(b,"syntax error");
+            return;
+        }
+        if (m_baudState != BAUD_IDLE)
+        {
+            sprintf(b,"busy");
+            return;
+        }
+
+        utils::CTextFormatter l_text(b, 16);
+        l_text.appendUnsigned(l_baudRate);
+        if (l_baudRate == m_baudRate) return;
+
+        m_baudRequest = l_baudRate;
+        m_baudState = BAUD_DRAINING;
+        startBaudTimer(std::chrono::milliseconds(1)); // the response is queued after the callback
+    }
+
+    /** @brief  Timer callback of the baud rate negotiation
+     *
+     *  It's applied from interrupt context, the negotiation continues in the run of the task.
+     */
+    void CSerialMonitor::baudTimerCallback()
+    {
+        m_baudTimerExpired = true;
+        notify();
+    }
+
+    /** @brief  Restarts the timer of the baud rate negotiation */
+    void CSerialMonitor::startBaudTimer(std::chrono::microseconds f_delay)
+    {
+        m_baudTimerExpired = false;
+        m_baudTimer.attach(mbed::callback(this, &CSerialMonitor::baudTimerCallback), f_delay);
+    }
+
+    /** @brief  Applies the baud rate on the port
+     *
+     *  The parsing restarts, the characters received during the switch are dropped.
+     *
+     *  @param f_baudRate     new baud rate
+     */
+    void CSerialMonitor::applyBaudRate(uint32_t f_baudRate)
+    {
+        m_serialPort.baud(f_baudRate);
+        m_serialTx.setBaudRate(f_baudRate);
+        m_baudRate = f_baudRate;
+        m_parseIt = m_serialTx.isBinaryMode() ? m_parseBuffer.begin() : m_parseBuffer.end();
+    }
+
+    /** @brief  Steps of the baud rate negotiation
+     *
+     *  The port is switched, when the response was transmitted and the last character left the shift register. If no valid message 
+     *  was received at the new rate until the timeout, the old rate is restored.
+     */
+    void CSerialMonitor::updateBaudRate()
+    {
+        if (!m_baudTimerExpired) return;
+
+        switch (m_baudState)
+        {
+            case BAUD_DRAINING:
+                if (!m_serialTx.isIdle())
+                {
+                    // Transmission time of the queued characters
+                    uint32_t l_time = (uint32_t)((uint64_t)(m_serialTx.getQueueDepth() + 1) * bits_per_character * 1000000 / m_baudRate);
+                    startBaudTimer(std::chrono::microseconds(l_time + 1000));
+                    return;
+                }
+                m_baudState = BAUD_SETTLING;
+                startBaudTimer(std::chrono::milliseconds(1));
+                break;
+
+            case BAUD_SETTLING:
+                m_baudFallback = m_baudRate;
+                applyBaudRate(m_baudRequest);
+                m_baudState = BAUD_VERIFYING;
+                startBaudTimer(baud_verify_timeout);
+                break;
+
+            case BAUD_VERIFYING:
+            {
+                applyBaudRate(m_baudFallback);
+                m_baudState = BAUD_IDLE;
+                m_baudTimerExpired = false;
+
+                char l_buffer[32];
+                utils::CTextFormatter l_text(l_buffer, sizeof(l_buffer));
+                l_text.append("@baud:").appendUnsigned(m_baudRate).append(";;\r\n");
+                m_serialTx.write(l_buffer, l_text.length(), CSerialTransmitter::ID_BAUD);
+                break;
+            }
+
+            default:
+                m_baudTimerExpired = false;
+                break;
+        }
+    }
+
     /** @brief  Rx callback actions
      *  
+     *  It's applied by the receiver from interrupt context, when received characters are available. Its time is the time of the 
+     *  reception of the messages started in the next run.
      */
     void CSerialMonitor::serialRxCallback()
     {
-        __disable_irq();
-        while ((m_serialPort.readable()) && (!m_RxBuffer.isFull())) {
-            char buf;
-            m_serialPort.read(&buf, 1);
-            m_RxBuffer.push(buf);
-        }
-        __enable_irq();
-        return;
+        m_rxTime = us_ticker_read();
+        notify();
     }
 
-    /** @brief  Tx callback actions
-     *  
+    /** @brief  Monitoring function
+     * 
+     * It has role to monitor the received messaged, it applies the read buffer content and decodes the messages if present. 
+     * All the received characters are processed in one run, at most rx_budget characters, so the latency of a command doesn't depend on its length. 
+     * If characters remained in the buffer, the task notifies itself to continue at the next pass of the task manager.
      */
-    void CSerialMonitor::serialTxCallback()
+    void CSerialMonitor::_run()
     {
-        __disable_irq();
-        while ((m_serialPort.writeable()) && (!m_TxBuffer.isEmpty())) {
-            // m_serialPort.write(m_TxBuffer.pop(), 1);
-            m_serialPort.write("a", 1);
+        uint32_t l_budget = rx_budget;
+        const char* l_chars;
+        uint32_t l_len;
+
+        // The contiguous parts of the receiver's buffer are parsed in place, at most two parts, when the data wraps around
+        while ((l_budget > 0) && ((l_len = m_receiver.peek(l_chars)) > 0))
+        {
+            if (l_len > l_budget) l_len = l_budget;
+            for (uint32_t i = 0; i < l_len; i++)
+            {
+                parseChar(l_chars[i]);
+            }
+            m_receiver.consume(l_len);
+            l_budget -= l_len;
         }
-        __enable_irq();
-        return;
+        if (!m_receiver.isEmpty()) notify(); // The remaining characters are processed at the next pass
+
+        if (m_baudState != BAUD_IDLE) updateBaudRate();
     }
 
-    /** @brief  Monitoring function
+    /** @brief  Parsing of a received character
+     * 
+     * The character is parsed according to the mode of the transmitter. The requested mode change is applied after the message, 
+     * the parsing restarts in the new mode.
+     * 
+     * @param f_c     received character
+     */
+    void CSerialMonitor::parseChar(char f_c)
+    {
+        if (m_serialTx.isBinaryMode()) parseBinary(f_c);
+        else parseText(f_c);
+
+        if (m_modeRequest >= 0)
+        {
+            m_serialTx.setBinaryMode(m_modeRequest == 1);
+            m_parseIt = (m_modeRequest == 1) ? m_parseBuffer.begin() : m_parseBuffer.end();
+            m_modeRequest = -1;
+        }
+    }
+
+    /** @brief  Parsing of a received character in text mode
+     * 
+     * The character is appended to the parse buffer. The '#' character starts a new message, the "\r\n" characters after the ";;" end the message, 
+     * which is dispatched. The characters after a dispatched message and after an overflow of the parse buffer are dropped until the next 
+     * message start, so a line without '#' is never dispatched.
+     * 
+     * @param f_c     received character
+     */
+    void CSerialMonitor::parseText(char f_c)
+    {
+        if ('#' == f_c) // Message starting special character
+        {
+            m_messageRxTime = m_rxTime;
+            m_parseIt = m_parseBuffer.begin();
+            m_parseIt[0] = f_c;
+            m_parseIt++;
+            return;
+        }
+        if (m_parseIt != m_parseBuffer.end())
+        {
+            if (f_c == '\n') // Message ending character
+            {
+                if ((m_parseIt - m_parseBuffer.begin() >= 4) && 
+                    (';' == m_parseIt[-3]) && (';' == m_parseIt[-2]) && ('\r' == m_parseIt[-1])) // Check the message ending
+                {
+                    dispatch();
+                    m_parseIt = m_parseBuffer.end(); // The characters are dropped until the next '#'
+                    return;
+                }
+            }
+            m_parseIt[0] = f_c;
+            m_parseIt++;
+        }
+    }
+
+    /** @brief  Parsing of a received byte in binary mode
+     * 
+     * The bytes are appended to the parse buffer until the zero delimiter, then the frame is dispatched. The frames longer than 
+     * the parse buffer are dropped.
+     * 
+     * @param f_c     received byte
+     */
+    void CSerialMonitor::parseBinary(char f_c)
+    {
+        if (0 == f_c) // Frame delimiter
+        {
+            if ((m_parseIt != m_parseBuffer.end()) && (m_parseIt != m_parseBuffer.begin()))
+            {
+                dispatchBinary(m_parseIt - m_parseBuffer.begin());
+            }
+            m_parseIt = m_parseBuffer.begin();
+            return;
+        }
+        if (m_parseIt == m_parseBuffer.begin()) // First character of the frame
+        {
+            m_messageRxTime = m_rxTime;
+        }
+        if (m_parseIt != m_parseBuffer.end())
+        {
+            m_parseIt[0] = f_c;
+            m_parseIt++;
+        }
+    }
+
+    /** @brief  Dispatching of a complete message
      * 
-     * It has role to monitor the received messaged, it applies periodically the read buffer content and decodes the message if present. 
      * Each validated message is redirected to the callback function corresponding to the message itself. The callback function requires two input as pointers,
-     *  one for message's content and one for response's content. After the applying the callback function, it will send the response to the other device.
+     * one for message's content and one for response's content. After the applying the callback function, it will send the response to the other device.
+     * The message "#key:content\r" is split in place at the ':' and '\r' characters, so the key and the content aren't copied. 
+     * The sequence number of an extended key ("#key/seq:content\r") is stamped with the times of the reception and the dispatch.
+     * 
+     * The message can contain several commands separated by '|' after their ";;" ending ("#speed:100;;|steer:50;;\r"). Only the syntax 
+     * and the keys are checked atomically: the message is dropped before the first command is applied, if one of them is malformed 
+     * or has an unknown key. The contents are checked by the callbacks, while the commands are applied in order in the same run, so 
+     * a rejected content doesn't undo the commands applied before it. The non-empty responses are sent in one line.
      */
-    void CSerialMonitor::_run()
+    void CSerialMonitor::dispatch()
     {
-        if ((!m_RxBuffer.isEmpty()))
+        struct SCommand
         {
-            char l_c = m_RxBuffer.pop(); // Read the next character from buffer
+            char* key;
+            char* content;
+            const SSubscriber* subscriber;
+            bool valid;
+            uint32_t sequence;
+        };
+        SCommand l_commands[max_frame_commands];
+        uint8_t l_count = 0;
 
-            if ('#' == l_c) // Message starting special character
+        char* l_it = m_parseBuffer.data() + 1; // after the '#'
+        char* l_end = &m_parseIt[-1]; // the '\r' character
+        while (l_it < l_end)
+        {
+            // The command ends at the separator after the ";;" or at the end of the message
+            char* l_cmdEnd = l_it;
+            while ((l_cmdEnd < l_end) && !(('|' == *l_cmdEnd) && (l_cmdEnd - l_it >= 2) && (';' == l_cmdEnd[-1]) && (';' == l_cmdEnd[-2])))
             {
-                m_parseIt = m_parseBuffer.begin();
-                m_parseIt[0] = l_c;
-                m_parseIt++;
-                return;
+                l_cmdEnd++;
             }
-            if (m_parseIt != m_parseBuffer.end())
+
+            char* l_msg = (char*)memchr(l_it, ':', l_cmdEnd - l_it);
+            if ((l_msg == NULL) || (l_msg == l_it) || (l_msg + 1 == l_cmdEnd) || (l_count == max_frame_commands)) return; // The key and the content can't be empty
+            *l_msg++ = '\0';
+            *l_cmdEnd = '\0';
+
+            SCommand& l_command = l_commands[l_count++];
+            l_command.key = l_it;
+            l_command.content = l_msg;
+            l_command.valid = false;
+
+            char* l_sequence = strchr(l_it, '/');
+            if (l_sequence != NULL) // Extended key with sequence number
             {
-                if (l_c == '\n') // Message ending character
-                {
-                    if ((';' == m_parseIt[-3]) && (';' == m_parseIt[-2]) && ('\r' == m_parseIt[-1])) // Check the message ending
-                    {
-                        char l_msgID[64];
-                        char l_msg[64];
-
-                        // uint32_t res = sscanf(m_parseBuffer.data(),"#%s:%s;;",l_msgID,l_msg); //Parse the message to key and content
-
-                        //The first %[^:] sets reading until the : character is encountered and the second %[^;] until the ;; is encountered.
-                        // uint32_t res = sscanf(m_parseBuffer.data(), "#%[^:]:%[^;];;", l_msgID, l_msg);
-
-                        uint32_t res = sscanf(m_parseBuffer.data(), "#%[^:]:%[^\r\n]", l_msgID, l_msg);
-
-                        if (res == 2) // Check the parsing
-                        {
-                            auto l_pair = m_serialSubscriberMap.find(l_msgID); // Search the key and gets the callback function pair
-                            if (l_pair != m_serialSubscriberMap.end()) // Check the existence of key 
-                            {
-                                char l_resp[128] = {0}; // Initial response message
-
-                                l_pair->second(l_msg,l_resp); // Call the attached function with this parameters.
-                                char formattedResp[256];
-                                if (strlen(l_resp) > 0)
-                                {
-                                    snprintf(formattedResp, sizeof(formattedResp), "@%s:%s;;\r\n", l_msgID, l_resp);
-                                    m_serialPort.write(formattedResp,strlen(formattedResp)); // Create the response message
-                                }
-                                
-                                // m_serialPort.write("@%s:%s\r\n",l_msgID,l_resp); // Create the response message
-                            }
-                        }
-                        m_parseIt = m_parseBuffer.begin(); //Go to begining of parse buffer.
-                    }
-                }
-                m_parseIt[0] = l_c;
-                m_parseIt++;
-                return;
+                *l_sequence++ = '\0';
+                if (!utils::CTextParser(l_sequence).next(l_command.sequence)) return;
+                l_command.valid = true;
             }
+
+            l_command.subscriber = findSubscriber(l_it); // Search the key and gets the callback function
+            if (l_command.subscriber == NULL) return;
+
+            l_it = l_cmdEnd + 1;
+        }
+        if (0 == l_count) return;
+
+        if (BAUD_VERIFYING == m_baudState) // A valid message verifies the new baud rate
+        {
+            m_baudTimer.detach();
+            m_baudState = BAUD_IDLE;
+        }
+
+        s_request.rxTime = m_messageRxTime;
+        char formattedResp[256];
+        utils::CTextFormatter l_text(formattedResp, sizeof(formattedResp));
+        uint8_t l_source = CSerialTransmitter::ID_TEXT;
+
+        for (uint8_t i = 0; i < l_count; i++)
+        {
+            s_request.valid = l_commands[i].valid;
+            s_request.sequence = l_commands[i].sequence;
+            s_request.dispatchTime = us_ticker_read();
+
+            char l_resp[128] = {0}; // Initial response message
+            l_commands[i].subscriber->callback(l_commands[i].content, l_resp); // Call the attached function with this parameters.
+            if (l_resp[0] == '\0') continue;
+
+            // The line is sent, when the next response may not fit in it
+            if ((l_text.length() > 0) && (l_text.length() + strlen(l_commands[i].key) + strlen(l_resp) + max_stamp_chars + 6 >= sizeof(formattedResp)))
+            {
+                l_text.append("\r\n");
+                m_serialTx.write(formattedResp, l_text.length(), l_source);
+                l_text.clear();
+            }
+            if (l_text.length() == 0) l_source = l_commands[i].subscriber->id;
+
+            l_text.appendChar((l_text.length() == 0) ? '@' : '|').append(l_commands[i].key);
+            appendStamp(l_text, s_request, us_ticker_read());
+            l_text.appendChar(':').append(l_resp).append(";;");
+        }
+        s_request.valid = false;
+
+        if (l_text.length() > 0)
+        {
+            l_text.append("\r\n");
+            m_serialTx.write(formattedResp, l_text.length(), l_source); // Create the response message
+        }
+    }
+
+    /** @brief  Dispatching of a complete binary frame
+     * 
+     * The frame is decoded and checked, the corrupted frames are dropped. The payload is given to the callback function of the subscriber 
+     * with the identifier of the frame as content of the message, the response is sent in a frame with the same identifier.
+     * 
+     * @param f_length     length of the encoded frame
+     */
+    void CSerialMonitor::dispatchBinary(uint32_t f_length)
+    {
+        int32_t l_length = utils::CBinaryFrame::decode((uint8_t*)m_parseBuffer.data(), f_length);
+        if ((l_length < 1) || (l_length - 1 > binary_payload_max)) return;
+
+        uint8_t l_id = m_parseBuffer[0];
+        if ((l_id >= subscriber_table_size) || (m_idTable[l_id] == empty_slot)) return;
+
+        if (BAUD_VERIFYING == m_baudState) // A valid frame verifies the new baud rate
+        {
+            m_baudTimer.detach();
+            m_baudState = BAUD_IDLE;
+        }
+
+        char l_msg[binary_payload_max + 1];
+        char l_resp[128] = {0}; // Initial response message
+
+        memcpy(l_msg, &m_parseBuffer[1], l_length - 1);
+        l_msg[l_length - 1] = '\0';
+
+        s_request.rxTime = m_messageRxTime;
+        s_request.dispatchTime = us_ticker_read();
+
+        m_subscribers[m_idTable[l_id]].callback(l_msg, l_resp);
+        if (strlen(l_resp) > 0)
+        {
+            m_serialTx.writeFrame(l_id, l_resp, strlen(l_resp));
+        }
+    }
+
+    /** @brief  Search of the subscriber with the key
+     * 
+     * The hash table is probed from the position given by the hash of the key until the key or a free position is found.
+     * 
+     * @param f_key     key of the message
+     * @return    The subscriber or NULL, if there is no subscriber with the key
+     */
+    const CSerialMonitor::SSubscriber* CSerialMonitor::findSubscriber(const char* f_key)
+    {
+        uint32_t l_slot = hashKey(f_key) & (subscriber_table_size - 1);
+        while (m_subscriberTable[l_slot] != empty_slot)
+        {
+            const SSubscriber* l_subscriber = &m_subscribers[m_subscriberTable[l_slot]];
+            if (strcmp(l_subscriber->key, f_key) == 0) return l_subscriber;
+            l_slot = (l_slot + 1) & (subscriber_table_size - 1);
         }
+        return NULL;
     }
 
 }; // namespace drivers
\ No newline at end of file
@@ -0,0 +1,277 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+
+#include <drivers/serialreceiver.hpp>
+
+#if SERIAL_RECEIVER_DMA
+// USART2_RX is served by the channel 4 of the DMA1 stream 5
+#define rx_dma_stream   DMA1_Stream5
+#define rx_dma_channel  4
+#define rx_dma_flags    (DMA_HIFCR_CTCIF5 | DMA_HIFCR_CHTIF5 | DMA_HIFCR_CTEIF5 | DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CFEIF5)
+#define rx_line_errors  (USART_SR_ORE | USART_SR_NE | USART_SR_FE | USART_SR_PE)
+#endif
+
+namespace drivers{
+
+#if SERIAL_RECEIVER_DMA
+    CSerialReceiver* CSerialReceiver::s_instance = NULL;
+    uint32_t CSerialReceiver::s_uartVector = 0;
+
+    /** @brief  CSerialReceiver class constructor
+     *
+     *  It starts the circular DMA transfer from the data register of the USART2 and enables the idle line and the error interrupts. 
+     *  The serial port has to be the USART2 (USBTX/USBRX on the Nucleo-F401RE) and its interrupts mustn't be attached. 
+     *
+     *  @param f_serialPort     reference to serial object
+     *  @param f_callback       callback applied from interrupt context after the reception
+     */
+    CSerialReceiver::CSerialReceiver(
+            UnbufferedSerial& f_serialPort,
+            mbed::Callback<void()> f_callback)
+        : m_buffer()
+        , m_tail(0)
+        , m_written(0)
+        , m_read(0)
+        , m_serialPort(f_serialPort)
+        , m_callback(f_callback)
+        , m_overflows(0)
+        , m_errors(0)
+    {
+        s_instance = this;
+
+        RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+        rx_dma_stream->CR &= ~DMA_SxCR_EN;
+        while (rx_dma_stream->CR & DMA_SxCR_EN) {}
+        DMA1->HIFCR = rx_dma_flags;
+
+        rx_dma_stream->PAR = (uint32_t)&USART2->DR;
+        rx_dma_stream->M0AR = (uint32_t)m_buffer;
+        rx_dma_stream->NDTR = rx_buffer_size;
+        rx_dma_stream->FCR = 0; // Direct mode
+        rx_dma_stream->CR = (rx_dma_channel << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_MINC | DMA_SxCR_CIRC | DMA_SxCR_HTIE | DMA_SxCR_TCIE;
+
+        NVIC_SetVector(DMA1_Stream5_IRQn, (uint32_t)&CSerialReceiver::dmaIrqHandler);
+        NVIC_EnableIRQ(DMA1_Stream5_IRQn);
+        s_uartVector = NVIC_GetVector(USART2_IRQn);
+        NVIC_SetVector(USART2_IRQn, (uint32_t)&CSerialReceiver::uartIrqHandler);
+        NVIC_EnableIRQ(USART2_IRQn);
+
+        rx_dma_stream->CR |= DMA_SxCR_EN;
+        USART2->CR3 |= USART_CR3_DMAR | USART_CR3_EIE;
+        USART2->CR1 |= USART_CR1_IDLEIE;
+    }
+
+    /** @brief  CSerialReceiver class destructor
+     *
+     *  It stops the DMA transfer and restores the serial interrupt handler.
+     */
+    CSerialReceiver::~CSerialReceiver()
+    {
+        USART2->CR1 &= ~USART_CR1_IDLEIE;
+        USART2->CR3 &= ~(USART_CR3_DMAR | USART_CR3_EIE);
+        rx_dma_stream->CR &= ~DMA_SxCR_EN;
+        NVIC_DisableIRQ(DMA1_Stream5_IRQn);
+        NVIC_SetVector(USART2_IRQn, s_uartVector);
+        s_instance = NULL;
+    }
+
+    /** @brief  Contiguous received characters
+     *
+     *  It gives the unread characters until the write position of the DMA or until the end of the buffer. 
+     *
+     *  @param f_chars      pointer to the first unread character
+     *  @return    Number of the contiguous characters
+     */
+    uint32_t CSerialReceiver::peek(const char*& f_chars)
+    {
+        uint32_t l_head = getHead();
+        __DMB(); // The characters are read after the position of the DMA
+        f_chars = &m_buffer[m_tail];
+        return (l_head >= m_tail) ? (l_head - m_tail) : (rx_buffer_size - m_tail);
+    }
+
+    /** @brief  Removes the peeked characters
+     *
+     *  @param f_len        number of characters, at most the number given by peek
+     */
+    void CSerialReceiver::consume(uint32_t f_len)
+    {
+        m_tail = (m_tail + f_len) & (rx_buffer_size - 1);
+        m_read += f_len;
+    }
+
+    /** @brief  Is empty method
+     *
+     *  @return    True if there is no unread character
+     */
+    bool CSerialReceiver::isEmpty()
+    {
+        return getHead() == m_tail;
+    }
+
+    /** @brief  Position of the DMA in the buffer, computed from the remaining transfers */
+    uint32_t CSerialReceiver::getHead()
+    {
+        return (rx_buffer_size - rx_dma_stream->NDTR) & (rx_buffer_size - 1);
+    }
+
+    /** @brief  DMA interrupt handler
+     *
+     *  It's applied, when the DMA reached the half and the end of the buffer, so the long receptions are processed before the 
+     *  buffer is overwritten. The written characters are counted by halves of the buffer, when more characters are unread than 
+     *  the size of the buffer, the excess was overwritten before the consumer read it.
+     */
+    void CSerialReceiver::dmaIrqHandler()
+    {
+        uint32_t l_flags = DMA1->HISR;
+        DMA1->HIFCR = rx_dma_flags;
+
+        if (l_flags & DMA_HISR_HTIF5) s_instance->m_written += rx_buffer_size / 2;
+        if (l_flags & DMA_HISR_TCIF5) s_instance->m_written += rx_buffer_size / 2;
+        uint32_t l_unread = s_instance->m_written - s_instance->m_read - s_instance->m_overflows;
+        if (l_unread > rx_buffer_size)
+        {
+            s_instance->m_overflows += l_unread - rx_buffer_size;
+        }
+        s_instance->m_callback();
+    }
+
+    /** @brief  Serial interrupt handler
+     *
+     *  It's applied, when the line became idle after a reception, so the end of each message is signaled without delay, 
+     *  and on the line errors, which are counted.
+     */
+    void CSerialReceiver::uartIrqHandler()
+    {
+        uint32_t l_status = USART2->SR;
+        if (l_status & rx_line_errors)
+        {
+            s_instance->m_errors++;
+        }
+        if (l_status & (USART_SR_IDLE | rx_line_errors))
+        {
+            (void)USART2->DR; // The idle and the error flags are cleared by reading the status and the data register
+        }
+        if (l_status & USART_SR_IDLE)
+        {
+            s_instance->m_callback();
+        }
+    }
+
+#else
+    /** @brief  CSerialReceiver class constructor
+     *
+     *  It attaches the receive interrupt of the serial port.
+     *
+     *  @param f_serialPort     reference to serial object
+     *  @param f_callback       callback applied from interrupt context after the reception
+     */
+    CSerialReceiver::CSerialReceiver(
+            UnbufferedSerial& f_serialPort,
+            mbed::Callback<void()> f_callback)
+        : m_buffer()
+        , m_serialPort(f_serialPort)
+        , m_callback(f_callback)
+        , m_overflows(0)
+        , m_errors(0)
+    {
+        m_serialPort.attach(mbed::callback(this,&CSerialReceiver::serialRxCallback), SerialBase::RxIrq);
+    }
+
+    /** @brief  CSerialReceiver class destructor
+     */
+    CSerialReceiver::~CSerialReceiver()
+    {
+        m_serialPort.attach(mbed::Callback<void()>(), SerialBase::RxIrq);
+    }
+
+    /** @brief  Contiguous received characters
+     *
+     *  @param f_chars      pointer to the first unread character
+     *  @return    Number of the contiguous characters
+     */
+    uint32_t CSerialReceiver::peek(const char*& f_chars)
+    {
+        return m_buffer.peek(f_chars);
+    }
+
+    /** @brief  Removes the peeked characters
+     *
+     *  @param f_len        number of characters, at most the number given by peek
+     */
+    void CSerialReceiver::consume(uint32_t f_len)
+    {
+        m_buffer.consume(f_len);
+    }
+
+    /** @brief  Is empty method
+     *
+     *  @return    True if there is no unread character
+     */
+    bool CSerialReceiver::isEmpty()
+    {
+        return m_buffer.isEmpty();
+    }
+
+    /** @brief  Injects received characters
+     *
+     *  The characters are handled as they were received by the serial port, the callback is applied. 
+     *  It can be used only, when the serial port doesn't receive (e.g. on host), the buffer has a single producer.
+     *
+     *  @param f_chars      received characters
+     *  @param f_len        number of characters
+     *  @return    Number of the characters added to the buffer
+     */
+    uint32_t CSerialReceiver::inject(const char* f_chars, uint32_t f_len)
+    {
+        uint32_t l_len = m_buffer.push(f_chars, f_len);
+        m_overflows += f_len - l_len;
+        m_callback();
+        return l_len;
+    }
+
+    /** @brief  Rx callback actions
+     *  
+     *  The interrupt is the only producer of the buffer, so it's filled without disabling the interrupts. 
+     *  The characters received into the full buffer are dropped and counted. Only the characters, which were read, are pushed.
+     */
+    void CSerialReceiver::serialRxCallback()
+    {
+        while (m_serialPort.readable()) {
+            char buf;
+            if (m_serialPort.read(&buf, 1) != 1) break;
+            if (!m_buffer.push(buf)) m_overflows++;
+        }
+        m_callback();
+    }
+#endif
+
+}; // namespace drivers
\ No newline at end of file
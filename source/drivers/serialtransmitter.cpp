@@ -0,0 +1,419 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+
+#include <drivers/serialtransmitter.hpp>
+
+#if SERIAL_TRANSMITTER_DMA
+// USART2_TX is served by the channel 4 of the DMA1 stream 6
+#define tx_dma_stream   DMA1_Stream6
+#define tx_dma_channel  4
+#define tx_dma_flags    (DMA_HIFCR_CTCIF6 | DMA_HIFCR_CHTIF6 | DMA_HIFCR_CTEIF6 | DMA_HIFCR_CDMEIF6 | DMA_HIFCR_CFEIF6)
+#endif
+
+#define tx_window_ms        1000
+#define bits_per_character  10 // start bit, 8 data bits and stop bit
+
+namespace drivers{
+
+#if SERIAL_TRANSMITTER_DMA
+    CSerialTransmitter* CSerialTransmitter::s_instance = NULL;
+
+    /** @brief  CSerialTransmitter class constructor
+     *
+     *  It configures the DMA transfer to the data register of the USART2. The serial port has to be the USART2 
+     *  (USBTX/USBRX on the Nucleo-F401RE).
+     *
+     *  @param f_serialPort     reference to serial object
+     *  @param f_baudRate       baud rate of the serial port, for the measurement of the load
+     */
+    CSerialTransmitter::CSerialTransmitter(
+            UnbufferedSerial& f_serialPort,
+            uint32_t f_baudRate)
+        : m_chunk(0)
+        , m_dmaDropped(0)
+        , m_serialPort(f_serialPort)
+        , m_buffer()
+        , m_queueMax(0)
+        , m_dropped(0)
+        , m_binaryMode(false)
+        , m_linkCapacity(f_baudRate / bits_per_character)
+        , m_rejected(0)
+        , m_windowStart(0)
+        , m_windowChars()
+        , m_rates()
+        , m_windowRejected(0)
+        , m_load(0)
+        , m_rejectedLast(false)
+    {
+        s_instance = this;
+
+        RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+        tx_dma_stream->CR &= ~DMA_SxCR_EN;
+        while (tx_dma_stream->CR & DMA_SxCR_EN) {}
+        DMA1->HIFCR = tx_dma_flags;
+
+        tx_dma_stream->PAR = (uint32_t)&USART2->DR;
+        tx_dma_stream->FCR = 0; // Direct mode
+        tx_dma_stream->CR = (tx_dma_channel << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_MINC | DMA_SxCR_DIR_0 | DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+
+        NVIC_SetVector(DMA1_Stream6_IRQn, (uint32_t)&CSerialTransmitter::dmaIrqHandler);
+        NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+        USART2->CR3 |= USART_CR3_DMAT;
+    }
+
+    /** @brief  CSerialTransmitter class destructor
+     *
+     *  It stops the DMA transfer.
+     */
+    CSerialTransmitter::~CSerialTransmitter()
+    {
+        NVIC_DisableIRQ(DMA1_Stream6_IRQn);
+        tx_dma_stream->CR &= ~DMA_SxCR_EN;
+        USART2->CR3 &= ~USART_CR3_DMAT;
+        s_instance = NULL;
+    }
+
+    /** @brief  Starts the transmission of the queue
+     *
+     *  If the DMA is idle, it starts the transfer of the contiguous part from the front of the queue. The interrupt of the DMA 
+     *  is disabled meanwhile, so the transfer is started only once.
+     */
+    void CSerialTransmitter::startTransmission()
+    {
+        NVIC_DisableIRQ(DMA1_Stream6_IRQn);
+        if (m_chunk == 0)
+        {
+            const char* l_chars;
+            uint32_t l_len = m_buffer.peek(l_chars);
+            if (l_len > 0)
+            {
+                m_chunk = l_len;
+                DMA1->HIFCR = tx_dma_flags;
+                tx_dma_stream->M0AR = (uint32_t)l_chars;
+                tx_dma_stream->NDTR = l_len;
+                tx_dma_stream->CR |= DMA_SxCR_EN;
+            }
+        }
+        NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+    }
+
+    /** @brief  DMA interrupt handler
+     *
+     *  It's applied at the end of the transfer, the transmitted characters are removed from the queue and the transfer of 
+     *  the next part is started. After a transfer error the chunk is removed too, but it's counted as dropped.
+     */
+    void CSerialTransmitter::dmaIrqHandler()
+    {
+        if (DMA1->HISR & DMA_HISR_TEIF6)
+        {
+            s_instance->m_dmaDropped += s_instance->m_chunk;
+        }
+        DMA1->HIFCR = tx_dma_flags;
+        s_instance->m_buffer.consume(s_instance->m_chunk);
+        s_instance->m_chunk = 0;
+        s_instance->startTransmission();
+    }
+
+#else
+    /** @brief  CSerialTransmitter class constructor
+     *
+     *  @param f_serialPort     reference to serial object
+     *  @param f_baudRate       baud rate of the serial port, for the measurement of the load
+     */
+    CSerialTransmitter::CSerialTransmitter(
+            UnbufferedSerial& f_serialPort,
+            uint32_t f_baudRate)
+        : m_active(false)
+        , m_serialPort(f_serialPort)
+        , m_buffer()
+        , m_queueMax(0)
+        , m_dropped(0)
+        , m_binaryMode(false)
+        , m_linkCapacity(f_baudRate / bits_per_character)
+        , m_rejected(0)
+        , m_windowStart(0)
+        , m_windowChars()
+        , m_rates()
+        , m_windowRejected(0)
+        , m_load(0)
+        , m_rejectedLast(false)
+    {
+    }
+
+    /** @brief  CSerialTransmitter class destructor
+     */
+    CSerialTransmitter::~CSerialTransmitter()
+    {
+        m_serialPort.attach(mbed::Callback<void()>(), SerialBase::TxIrq);
+    }
+
+    /** @brief  Starts the transmission of the queue
+     *
+     *  It attaches the transmit interrupt, if it isn't attached yet.
+     */
+    void CSerialTransmitter::startTransmission()
+    {
+        core_util_critical_section_enter();
+        if (!m_active)
+        {
+            m_active = true;
+            m_serialPort.attach(mbed::callback(this,&CSerialTransmitter::serialTxCallback), SerialBase::TxIrq);
+        }
+        core_util_critical_section_exit();
+    }
+
+    /** @brief  Tx callback actions
+     *  
+     *  The interrupt is the only consumer of the queue. It's detached, when the queue became empty.
+     */
+    void CSerialTransmitter::serialTxCallback()
+    {
+        char l_c;
+        while ((m_serialPort.writeable()) && (m_buffer.pop(l_c))) {
+            m_serialPort.write(&l_c, 1);
+        }
+        if (m_buffer.isEmpty())
+        {
+            m_active = false;
+            m_serialPort.attach(mbed::Callback<void()>(), SerialBase::TxIrq);
+        }
+    }
+#endif
+
+    /** @brief  Queues a message for transmission
+     *
+     *  In text mode the message is queued as it is. In binary mode it is split into ID_TEXT frames.
+     *
+     *  @param f_buffer     message
+     *  @param f_length     number of characters
+     *  @param f_source     identifier of the producer, for the measurement of the rates
+     *  @param f_priority   priority of the message
+     *  @return    Number of the queued characters, zero if the message was dropped
+     */
+    ssize_t CSerialTransmitter::write(const void* f_buffer, std::size_t f_length, uint8_t f_source, EPriority f_priority)
+    {
+        if (!m_binaryMode) return queue(f_buffer, f_length, f_source, f_priority);
+
+        const uint8_t* l_chars = (const uint8_t*)f_buffer;
+        ssize_t l_queued = 0;
+        while (f_length > 0)
+        {
+            std::size_t l_length = (f_length > binary_payload_max) ? binary_payload_max : f_length;
+            l_queued += queueFrame(ID_TEXT, l_chars, l_length, f_source, f_priority);
+            l_chars += l_length;
+            f_length -= l_length;
+        }
+        return l_queued;
+    }
+
+    /** @brief  Queues a binary frame for transmission
+     *
+     *  The frame is encoded and queued also in text mode.
+     *
+     *  @param f_id         identifier of the frame, it's the source of the characters too
+     *  @param f_payload    payload
+     *  @param f_length     length of the payload, at most binary_payload_max
+     *  @param f_priority   priority of the frame
+     *  @return    Number of the queued characters, zero if the frame was dropped
+     */
+    ssize_t CSerialTransmitter::writeFrame(uint8_t f_id, const void* f_payload, std::size_t f_length, EPriority f_priority)
+    {
+        return queueFrame(f_id, f_payload, f_length, f_id, f_priority);
+    }
+
+    /** @brief  Encodes and queues a binary frame
+     *
+     *  @param f_id         identifier of the frame
+     *  @param f_payload    payload
+     *  @param f_length     length of the payload, at most binary_payload_max
+     *  @param f_source     identifier of the producer
+     *  @param f_priority   priority of the frame
+     *  @return    Number of the queued characters, zero if the frame was dropped
+     */
+    ssize_t CSerialTransmitter::queueFrame(uint8_t f_id, const void* f_payload, std::size_t f_length, uint8_t f_source, EPriority f_priority)
+    {
+        uint8_t l_frame[binary_frame_max];
+        uint32_t l_length = utils::CBinaryFrame::encode(f_id, (const uint8_t*)f_payload, f_length, l_frame);
+        if (l_length == 0)
+        {
+            m_dropped += f_length;
+            return 0;
+        }
+        return queue(l_frame, l_length, f_source, f_priority);
+    }
+
+    /** @brief  Selects the binary or the text mode */
+    void CSerialTransmitter::setBinaryMode(bool f_binary)
+    {
+        m_binaryMode = f_binary;
+    }
+
+    /** @brief  Binary mode is selected */
+    bool CSerialTransmitter::isBinaryMode()
+    {
+        return m_binaryMode;
+    }
+
+    /** @brief  Copies the characters into the queue
+     *
+     *  The characters are copied into the queue and their transmission is started in background. If they don't fit 
+     *  into the queue, they are dropped entirely, so no partial message is sent. The telemetry characters are rejected, 
+     *  when they would use the space reserved for the responses.
+     *
+     *  @param f_buffer     characters
+     *  @param f_length     number of characters
+     *  @param f_source     identifier of the producer
+     *  @param f_priority   priority of the characters
+     *  @return    Number of the queued characters, zero if the characters were dropped
+     */
+    ssize_t CSerialTransmitter::queue(const void* f_buffer, std::size_t f_length, uint8_t f_source, EPriority f_priority)
+    {
+        updateWindow();
+
+        uint32_t l_free = m_buffer.getCapacity() - m_buffer.getSize();
+        if ((PRIORITY_TELEMETRY == f_priority) && (f_length + tx_telemetry_reserve > l_free))
+        {
+            m_rejected += f_length;
+            m_windowRejected += f_length;
+            return 0;
+        }
+        if (f_length > l_free)
+        {
+            m_dropped += f_length;
+            return 0;
+        }
+        m_buffer.push((const char*)f_buffer, f_length);
+
+        uint32_t l_depth = m_buffer.getSize();
+        if (l_depth > m_queueMax) m_queueMax = l_depth;
+        if (f_source < id_count) m_windowChars[f_source] += f_length;
+
+        startTransmission();
+        return f_length;
+    }
+
+    /** @brief  Closes the measurement window, when it elapsed
+     *
+     *  The characters of the elapsed window became the rates of the sources. If more windows elapsed without characters, the 
+     *  rates are zero.
+     */
+    void CSerialTransmitter::updateWindow()
+    {
+        uint32_t l_now = (uint32_t)Kernel::Clock::now().time_since_epoch().count();
+        uint32_t l_elapsed = l_now - m_windowStart;
+        if (l_elapsed < tx_window_ms) return;
+
+        uint32_t l_total = 0;
+        for (uint8_t i = 0; i < id_count; i++)
+        {
+            m_rates[i] = (l_elapsed < 2 * tx_window_ms) ? m_windowChars[i] : 0;
+            l_total += m_rates[i];
+            m_windowChars[i] = 0;
+        }
+        uint32_t l_load = (m_linkCapacity > 0) ? (uint32_t)(((uint64_t)l_total * 10000) / m_linkCapacity) : 0;
+        m_load = (l_load > UINT16_MAX) ? UINT16_MAX : (uint16_t)l_load;
+        m_rejectedLast = (m_windowRejected > 0) && (l_elapsed < 2 * tx_window_ms);
+        m_windowRejected = 0;
+        m_windowStart = l_now;
+    }
+
+    /** @brief  Number of the queued characters */
+    uint32_t CSerialTransmitter::getQueueDepth()
+    {
+        return m_buffer.getSize();
+    }
+
+    /** @brief  Maximum number of the queued characters since the last reset */
+    uint32_t CSerialTransmitter::getQueueMax()
+    {
+        return m_queueMax;
+    }
+
+    /** @brief  Restarts the measurement of the maximum number of the queued characters */
+    void CSerialTransmitter::resetQueueMax()
+    {
+        m_queueMax = m_buffer.getSize();
+    }
+
+    /** @brief  Number of the dropped characters, the rejected ones and the ones lost by transfer errors of the DMA */
+    uint32_t CSerialTransmitter::getDropped()
+    {
+#if SERIAL_TRANSMITTER_DMA
+        return m_dropped + m_dmaDropped;
+#else
+        return m_dropped;
+#endif
+    }
+
+    /** @brief  Set the baud rate used for the measurement of the load, after the baud rate of the serial port was changed */
+    void CSerialTransmitter::setBaudRate(uint32_t f_baudRate)
+    {
+        m_linkCapacity = f_baudRate / bits_per_character;
+    }
+
+    /** @brief  The queue is empty and no transmission is in progress, the last character may be still in the shift register of the port */
+    bool CSerialTransmitter::isIdle()
+    {
+#if SERIAL_TRANSMITTER_DMA
+        return m_buffer.isEmpty() && (m_chunk == 0);
+#else
+        return m_buffer.isEmpty() && !m_active;
+#endif
+    }
+
+    /** @brief  Number of the telemetry characters rejected for keeping the space of the responses */
+    uint32_t CSerialTransmitter::getRejected()
+    {
+        return m_rejected;
+    }
+
+    /** @brief  Characters per second queued by the source in the last window */
+    uint32_t CSerialTransmitter::getRate(uint8_t f_source)
+    {
+        updateWindow();
+        return (f_source < id_count) ? m_rates[f_source] : 0;
+    }
+
+    /** @brief  Load of the link in the last window, in hundredths of percent of the characters transmittable at the baud rate */
+    uint16_t CSerialTransmitter::getLoad()
+    {
+        updateWindow();
+        return m_load;
+    }
+
+    /** @brief  The link is congested: the load reached congestion_load or telemetry characters were rejected in the last window */
+    bool CSerialTransmitter::isCongested()
+    {
+        updateWindow();
+        return (m_load >= congestion_load) || m_rejectedLast;
+    }
+
+}; // namespace drivers
\ No newline at end of file
@@ -32,31 +32,36 @@
 #include <main.hpp>
 
 #define dummy_value 15
+#define _32_chars 32
+#define serial_baud_rate 115200
 
 // Base sample time for the task manager. The measurement unit of base sample time is milliseconds.
 const std::chrono::milliseconds g_baseTick = std::chrono::milliseconds(1);
 
 // Serial interface with the another device(like single board computer). It's an built-in class of mbed based on the UART communication, the inputs have to be transmitter and receiver pins. 
-UnbufferedSerial g_rpi(USBTX, USBRX, 115200);
+UnbufferedSerial g_rpi(USBTX, USBRX, serial_baud_rate);
 
 auto dummy = []() {
     g_rpi.write("# Booting up... wait for I'm alive #\r\n", 37);
     return 0;
 }();
 
+// Transmitter of the messages, the tasks queue their messages and the transmission is made in background, without blocking the tasks.
+drivers::CSerialTransmitter g_serialTx(g_rpi, serial_baud_rate);
+
 // It's a task for blinking periodically the built-in led on the Nucleo board, signaling the code is uploaded on the nucleo.
 periodics::CBlinker g_blinker(g_baseTick * 500, LED1);
 
 periodics::CAlerts g_alerts(g_baseTick * 5000);
 
 // // It's a task for sending periodically the instant current consumption of the battery
-periodics::CInstantConsumption g_instantconsumption(g_baseTick * 1000, A2, g_rpi);
+periodics::CInstantConsumption g_instantconsumption(g_baseTick * 1000, A2, g_serialTx);
 
 // // It's a task for sending periodically the battery voltage, so to notice when discharging
-periodics::CTotalVoltage g_totalvoltage(g_baseTick*3000, A4, g_rpi);
+periodics::CTotalVoltage g_totalvoltage(g_baseTick*3000, A4, g_serialTx);
 
 // It's a task for sending periodically the IMU values
-periodics::CImu g_imu(g_baseTick*150, g_rpi, I2C_SDA, I2C_SCL);
+periodics::CImu g_imu(g_baseTick*150, g_serialTx, I2C_SDA, I2C_SCL);
 
 //PIN for a motor speed in ms, inferior and superior limit
 drivers::CSpeedingMotor g_speedingDriver(D3, -500, 500); //speed in mm/s
@@ -65,13 +70,26 @@ drivers::CSpeedingMotor g_speedingDriver(D3, -500, 500); //speed in mm/s
 drivers::CSteeringMotor g_steeringDriver(D4, -250, 250);
 
 // Create the motion controller, which controls the robot states and the robot moves based on the transmitted command over the serial interface.
-brain::CRobotStateMachine g_robotstatemachine(g_baseTick * 1, g_rpi, g_steeringDriver, g_speedingDriver);
+// It's run by the commands, the period is only the idle check, so the task manager can sleep between the commands.
+brain::CRobotStateMachine g_robotstatemachine(g_baseTick * 1000, g_serialTx, g_steeringDriver, g_speedingDriver);
+
+// The task manager is created after the list of tasks, it's declared here for the tasks reporting its statistics.
+extern utils::CTaskManager g_taskManager;
+
+// The serial monitor is created after the list of subscribers, it's declared here for its own commands and the statistics of the reception.
+extern drivers::CSerialMonitor g_serialMonitor;
+
+periodics::CResourcemonitor g_resourceMonitor(g_baseTick * 5000, g_serialTx, g_taskManager, g_serialMonitor);
 
-periodics::CResourcemonitor g_resourceMonitor(g_baseTick * 5000, g_rpi);
+// It's a task for synchronising the board's clock to the host's clock, the telemetry is stamped with host time
+periodics::CClockSync g_clockSync(g_baseTick * 100, g_serialTx);
+
+// It's a task for sending the latest values of the IMU, battery, instant consumption and resources in one message, the host subscribes to the topics
+periodics::CTelemetry g_telemetry(g_baseTick * 10, g_serialTx, g_imu, g_totalvoltage, g_instantconsumption, g_resourceMonitor, g_clockSync);
 
 brain::CKlmanager g_klmanager(g_alerts, g_imu, g_instantconsumption, g_totalvoltage, g_robotstatemachine, g_resourceMonitor);
 
-periodics::CPowermanager g_powermanager(g_baseTick * 100, g_klmanager, g_rpi, g_totalvoltage, g_instantconsumption, g_alerts);
+periodics::CPowermanager g_powermanager(g_baseTick * 100, g_klmanager, g_serialTx, g_totalvoltage, g_instantconsumption, g_alerts);
 
 brain::CBatterymanager g_batteryManager(dummy_value);
 
@@ -79,25 +97,35 @@ brain::CBatterymanager g_batteryManager(dummy_value);
 
 /* USER NEW COMPONENT END */
 
-// Map for redirecting messages with the key and the callback functions. If the message key equals to one of the enumerated keys, than it will be applied the paired callback function.
-drivers::CSerialMonitor::CSerialSubscriberMap g_serialMonitorSubscribers = {
-    {"speed",          mbed::callback(&g_robotstatemachine, &brain::CRobotStateMachine::serialCallbackSPEEDcommand)},
-    {"steer",          mbed::callback(&g_robotstatemachine, &brain::CRobotStateMachine::serialCallbackSTEERcommand)},
-    {"brake",          mbed::callback(&g_robotstatemachine, &brain::CRobotStateMachine::serialCallbackBRAKEcommand)},
-    {"vcd",            mbed::callback(&g_robotstatemachine, &brain::CRobotStateMachine::serialCallbackVCDcommand)},
-    {"vcdCalib",       mbed::callback(&g_robotstatemachine, &brain::CRobotStateMachine::serialCallbackVCDCalibcommand)},
-    {"steerLimits",    mbed::callback(&g_robotstatemachine, &brain::CRobotStateMachine::serialCallbackSteerLimitscommand)},
-    {"alive",          mbed::callback(&g_robotstatemachine, &brain::CRobotStateMachine::serialCallbackAlivecommand)},
-    {"battery",        mbed::callback(&g_totalvoltage,      &periodics::CTotalVoltage::serialCallbackTOTALVcommand)},
-    {"instant",        mbed::callback(&g_instantconsumption,&periodics::CInstantConsumption::serialCallbackINSTANTcommand)},
-    {"imu",            mbed::callback(&g_imu,               &periodics::CImu::serialCallbackIMUcommand)},
-    {"kl",             mbed::callback(&g_klmanager,         &brain::CKlmanager::serialCallbackKLCommand)},
-    {"batteryCapacity",mbed::callback(&g_batteryManager,    &brain::CBatterymanager::serialCallbackBATTERYCommand)},
-    {"resourceMonitor",mbed::callback(&g_resourceMonitor,   &periodics::CResourcemonitor::serialCallbackRESMONCommand)},
+// List for redirecting messages with the key and the callback functions. If the message key equals to one of the enumerated keys, than it will be applied the paired callback function.
+const drivers::CSerialMonitor::SSubscriber g_serialMonitorSubscribers[] = {
+    {"speed",          mbed::callback(&g_robotstatemachine, &brain::CRobotStateMachine::serialCallbackSPEEDcommand), drivers::CSerialTransmitter::ID_SPEED},
+    {"steer",          mbed::callback(&g_robotstatemachine, &brain::CRobotStateMachine::serialCallbackSTEERcommand), drivers::CSerialTransmitter::ID_STEER},
+    {"brake",          mbed::callback(&g_robotstatemachine, &brain::CRobotStateMachine::serialCallbackBRAKEcommand), drivers::CSerialTransmitter::ID_BRAKE},
+    {"vcd",            mbed::callback(&g_robotstatemachine, &brain::CRobotStateMachine::serialCallbackVCDcommand), drivers::CSerialTransmitter::ID_VCD},
+    {"vcdCalib",       mbed::callback(&g_robotstatemachine, &brain::CRobotStateMachine::serialCallbackVCDCalibcommand), drivers::CSerialTransmitter::ID_VCD_CALIB},
+    {"steerLimits",    mbed::callback(&g_robotstatemachine, &brain::CRobotStateMachine::serialCallbackSteerLimitscommand), drivers::CSerialTransmitter::ID_STEER_LIMITS},
+    {"alive",          mbed::callback(&g_robotstatemachine, &brain::CRobotStateMachine::serialCallbackAlivecommand), drivers::CSerialTransmitter::ID_ALIVE},
+    {"battery",        mbed::callback(&g_totalvoltage,      &periodics::CTotalVoltage::serialCallbackTOTALVcommand), drivers::CSerialTransmitter::ID_BATTERY},
+    {"instant",        mbed::callback(&g_instantconsumption,&periodics::CInstantConsumption::serialCallbackINSTANTcommand), drivers::CSerialTransmitter::ID_INSTANT},
+    {"imu",            mbed::callback(&g_imu,               &periodics::CImu::serialCallbackIMUcommand), drivers::CSerialTransmitter::ID_IMU},
+    {"imuStream",      mbed::callback(&g_imu,               &periodics::CImu::serialCallbackIMUSTREAMcommand), drivers::CSerialTransmitter::ID_IMU_STREAM},
+    {"i2c",            mbed::callback(&g_imu,               &periodics::CImu::serialCallbackI2Ccommand), drivers::CSerialTransmitter::ID_I2C},
+    {"imuQuat",        mbed::callback(&g_imu,               &periodics::CImu::serialCallbackIMUQUATcommand), drivers::CSerialTransmitter::ID_IMU_QUAT},
+    {"kl",             mbed::callback(&g_klmanager,         &brain::CKlmanager::serialCallbackKLCommand), drivers::CSerialTransmitter::ID_KL},
+    {"batteryCapacity",mbed::callback(&g_batteryManager,    &brain::CBatterymanager::serialCallbackBATTERYCommand), drivers::CSerialTransmitter::ID_BATTERY_CAPACITY},
+    {"resourceMonitor",mbed::callback(&g_resourceMonitor,   &periodics::CResourcemonitor::serialCallbackRESMONCommand), drivers::CSerialTransmitter::ID_RESOURCE_MONITOR},
+    {"taskStats",      mbed::callback(&g_resourceMonitor,   &periodics::CResourcemonitor::serialCallbackTASKSTATSCommand), drivers::CSerialTransmitter::ID_TASK_STATS},
+    {"sub",            mbed::callback(&g_telemetry,         &periodics::CTelemetry::serialCallbackSUBcommand), drivers::CSerialTransmitter::ID_SUBSCRIBE},
+    {"bandwidth",      mbed::callback(&g_telemetry,         &periodics::CTelemetry::serialCallbackBANDWIDTHcommand), drivers::CSerialTransmitter::ID_BANDWIDTH},
+    {"sync",           mbed::callback(&g_clockSync,         &periodics::CClockSync::serialCallbackSYNCcommand), drivers::CSerialTransmitter::ID_SYNC},
+    {"clock",          mbed::callback(&g_clockSync,         &periodics::CClockSync::serialCallbackCLOCKcommand), drivers::CSerialTransmitter::ID_CLOCK},
+    {"binary",         mbed::callback(&g_serialMonitor,     &drivers::CSerialMonitor::serialCallbackBINARYcommand), drivers::CSerialTransmitter::ID_BINARY},
+    {"baud",           mbed::callback(&g_serialMonitor,     &drivers::CSerialMonitor::serialCallbackBAUDcommand), drivers::CSerialTransmitter::ID_BAUD},
 };
 
 // Create the serial monitor object, which decodes, redirects the messages and transmits the responses.
-drivers::CSerialMonitor g_serialMonitor(g_rpi, g_serialMonitorSubscribers);
+drivers::CSerialMonitor g_serialMonitor(g_rpi, g_serialTx, g_serialMonitorSubscribers, sizeof(g_serialMonitorSubscribers)/sizeof(drivers::CSerialMonitor::SSubscriber), serial_baud_rate);
 
 // List of the task, each task will be applied their own periodicity, defined by the initializing the objects.
 utils::CTask* g_taskList[] = {
@@ -109,6 +137,8 @@ utils::CTask* g_taskList[] = {
     &g_serialMonitor,
     &g_powermanager,
     &g_resourceMonitor,
+    &g_clockSync,
+    &g_telemetry,
     &g_alerts,
     // USER NEW PERIODICS BEGIN
     
@@ -116,8 +146,32 @@ utils::CTask* g_taskList[] = {
 }; 
 
 // Create the task manager, which applies periodically the tasks, miming a parallelism. It needs the list of task and the time base in seconds. 
+// Between the deadlines of the tasks the main loop sleeps, it is woken up by the serial reception too.
 utils::CTaskManager g_taskManager(g_taskList, sizeof(g_taskList)/sizeof(utils::CTask*), g_baseTick);
 
+/**
+ * @brief Deadline callback of the task manager. It reports the index of the task (position in the task list) and the type of the miss, 
+ * 1 for hard deadline and 0 for missed activations. The missed activations are alerted with the buzzer, the hard deadline misses 
+ * only when the motors are enabled (kl 30).
+ * 
+ * @param f_task        task, which missed its deadline
+ * @param f_hard        true for hard deadline miss
+ */
+void deadlineCallback(utils::CTask& f_task, bool f_hard)
+{
+    char l_buffer[_32_chars];
+    char l_response[_32_chars];
+
+    utils::CTextFormatter l_text(l_buffer, sizeof(l_buffer));
+    l_text.append("@deadline:").appendUnsigned(f_task.getId()).appendChar(';').appendChar(f_hard ? '1' : '0').append(";;\r\n");
+    g_serialTx.write(l_buffer, l_text.length());
+
+    if(!f_hard || (uint8_globalsV_value_of_kl == 30))
+    {
+        g_alerts.alertsCommand("5", l_response);
+    }
+}
+
 /**
  * @brief Setup function for initializing some objects and transmitting a startup message through the serial. 
  * 
@@ -130,13 +184,15 @@ uint8_t setup()
     //     /* parity */ SerialBase::None,
     //     /* stop bit */ 1
     // );
-    g_rpi.write("\r\n\r\n", 4);
-    g_rpi.write("#################\r\n", 19);
-    g_rpi.write("#               #\r\n", 19);
-    g_rpi.write("#   I'm alive   #\r\n", 19);
-    g_rpi.write("#               #\r\n", 19);
-    g_rpi.write("#################\r\n", 19);
-    g_rpi.write("\r\n", 2);
+    g_serialTx.write("\r\n\r\n", 4);
+    g_serialTx.write("#################\r\n", 19);
+    g_serialTx.write("#               #\r\n", 19);
+    g_serialTx.write("#   I'm alive   #\r\n", 19);
+    g_serialTx.write("#               #\r\n", 19);
+    g_serialTx.write("#################\r\n", 19);
+    g_serialTx.write("\r\n", 2);
+
+    g_taskManager.attachDeadlineCallback(mbed::callback(deadlineCallback));
 
     return 0;    
 }
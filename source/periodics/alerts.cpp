@@ -121,9 +121,9 @@ namespace periodics
 
     void CAlerts::alertsCommand(char const * a, char * b) {
         uint8_t l_isActivate=0;
-        uint8_t l_res = sscanf(a,"%hhu",&l_isActivate);
+        utils::CTextParser l_parser(a);
 
-        if(1 == l_res){
+        if(l_parser.nextAs<uint8_t>(l_isActivate, 0, UINT8_MAX)){
 
             m_isActive=(l_isActivate>=1);
             sprintf(b,"%hhu", l_isActivate);
@@ -137,7 +137,7 @@ namespace periodics
                 setNewPeriod(5000);
                 m_period = 5000;
 
-            } else if(1<= l_isActivate && 4 >= l_isActivate){
+            } else if(1<= l_isActivate && 5 >= l_isActivate){
                 current_step = 0;
                 step_counter = 0;
                 tone_active = false;
@@ -883,6 +883,51 @@ namespace periodics
                     buzzer.period_us(2);
                     buzzer.pulsewidth_us(1);
                     
+                    alert_id = 0;
+                    setNewPeriod(5000);
+                    m_period = 5000;
+                    break;
+            }
+        } else if(5 == alert_id){
+            // Missed deadline: three short beeps
+            switch (current_step) {
+                case 0:
+                case 2:
+                case 4:
+                    if (!tone_active) {
+                        buzzer.period_us(1000000 / NOTE_A6);
+                        buzzer.pulsewidth_us((1000000 / NOTE_A6) / 2);
+                        tone_active = true;
+                        step_counter = 0;
+                    } else if (step_counter >= 5) {
+                        buzzer.pulsewidth_us(0);
+                        tone_active = false;
+                        step_counter = 0;
+                        current_step++;
+                    } else {
+                        step_counter++;
+                    }
+                    break;
+
+                case 1:
+                case 3:
+                    if (step_counter >= 5) {
+                        step_counter = 0;
+                        current_step++;
+                    } else {
+                        step_counter++;
+                    }
+                    break;
+
+                case 5:
+                    buzzer.period_us(2);
+                    buzzer.pulsewidth_us(1);
+
+                    current_step = 0;
+                    tone_active = false;
+                    step_counter = 0;
+                    buzzer.pulsewidth_us(0);
+
                     alert_id = 0;
                     setNewPeriod(5000);
                     m_period = 5000;
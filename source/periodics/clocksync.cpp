@@ -0,0 +1,250 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+#include <periodics/clocksync.hpp>
+
+#define _32_chars 32
+#define _100_chars 100
+#define max_sync_period_ms 60000
+#define delay_margin_us 200
+#define max_step_us 10000
+#define max_drift_ppb 500000
+#define ppb_scale 1000000000
+
+namespace periodics{
+    /** \brief  Class constructor
+     *
+     *  It initializes the task without polling, the clock isn't synchronised.
+     *
+     *  \param f_period               period of the task, the resolution of the polling period
+     *  \param f_serial               serial transmitter of the polls
+     */
+    CClockSync::CClockSync(
+            std::chrono::milliseconds f_period,
+            drivers::CSerialTransmitter& f_serial)
+        : utils::CTask(f_period)
+        , m_serial(f_serial)
+        , m_basePeriod((f_period.count() > 0) ? f_period.count() : 1)
+        , m_pollCycles(0)
+        , m_pollCounter(0)
+        , m_pollPending(false)
+        , m_pollTime(0)
+        , m_samples(0)
+        , m_refTime(0)
+        , m_refOffset(0)
+        , m_drift(0)
+        , m_minDelay(0)
+        , m_quality(0)
+    {
+    }
+
+    /** @brief  CClockSync class destructor
+     */
+    CClockSync::~CClockSync()
+    {
+    };
+
+    /** \brief  Serial callback method of the synchronisation
+     *
+     *  The message with one field is the polling period in milliseconds ("1000"), the response is the applied period. The message 
+     *  with three fields is the answer of the host to the last poll ("T1;T2;T3"), it has no response. The answers of the older 
+     *  polls are ignored.
+     *
+     *  @param a                   input received string
+     *  @param b                   output reponse message
+     */
+    void CClockSync::serialCallbackSYNCcommand(char const * a, char * b)
+    {
+        utils::CTextParser l_parser(a);
+        uint32_t l_first;
+        if(!l_parser.next(l_first))
+        {
+            sprintf(b,"syntax error");
+            return;
+        }
+
+        // The host times are optional, the empty field of the ";;" ending marks the period
+        const char* l_field;
+        uint32_t l_fieldLength;
+        utils::CTextParser l_optional(l_parser);
+        if(!l_parser.nextField(l_field, l_fieldLength) || (0 == l_fieldLength))
+        {
+            if(l_first > max_sync_period_ms)
+            {
+                sprintf(b,"syntax error");
+                return;
+            }
+            m_pollCycles = (uint16_t)((l_first + m_basePeriod - 1) / m_basePeriod);
+            m_pollCounter = (m_pollCycles > 0) ? 1 : 0; // the first poll is sent at the next cycle
+            m_pollPending = false;
+            utils::CTextFormatter l_text(b, _32_chars);
+            l_text.appendUnsigned(m_pollCycles * m_basePeriod);
+            return;
+        }
+
+        uint32_t l_t2, l_t3;
+        if(!l_optional.next(l_t2) || !l_optional.next(l_t3))
+        {
+            sprintf(b,"syntax error");
+            return;
+        }
+
+        if(!m_pollPending || (l_first != m_pollTime)) return;
+        m_pollPending = false;
+        update(l_first, l_t2, l_t3, drivers::CSerialMonitor::currentRequest().rxTime);
+    }
+
+    /** \brief  Serial callback method to report the state of the synchronisation
+     *
+     *  The response is "SYNCED;OFFSET;DRIFT;DELAY;QUALITY", the offset of the host clock, the minimum round trip delay and 
+     *  the quality in microseconds, the drift in parts per billion.
+     *
+     *  @param a                   input received string
+     *  @param b                   output reponse message
+     */
+    void CClockSync::serialCallbackCLOCKcommand(char const * a, char * b)
+    {
+        uint8_t l_request = 0;
+        utils::CTextParser l_parser(a);
+        if(!l_parser.nextAs<uint8_t>(l_request, 0, UINT8_MAX))
+        {
+            sprintf(b,"syntax error");
+            return;
+        }
+
+        utils::CTextFormatter l_text(b, _100_chars);
+        l_text.appendUnsigned(isSynced() ? 1 : 0).appendChar(';').appendSigned((int32_t)m_refOffset).appendChar(';').appendSigned(m_drift)
+              .appendChar(';').appendUnsigned(m_minDelay).appendChar(';').appendUnsigned(m_quality);
+    }
+
+    /** \brief  Maps the board time to host time
+     *
+     *  @param f_boardTime        board time in microseconds
+     *  @param f_hostTime         host time in microseconds, the board time while there's no estimation
+     *  @return                   true, when the clock is synchronised
+     */
+    bool CClockSync::toHost(uint32_t f_boardTime, uint32_t& f_hostTime)
+    {
+        if(0 == m_samples)
+        {
+            f_hostTime = f_boardTime;
+            return false;
+        }
+
+        int32_t l_elapsed = (int32_t)(f_boardTime - m_refTime);
+        f_hostTime = f_boardTime + m_refOffset + (uint32_t)(int32_t)((int64_t)m_drift * l_elapsed / ppb_scale);
+        return isSynced();
+    }
+
+    /** \brief  Updates the estimation with an exchange
+     *
+     *  The exchanges with too long round trip are dropped. The estimation restarts, when the offset jumped more than max_step_us 
+     *  (e.g. the host clock was set).
+     *
+     *  @param f_t1               board time of the poll
+     *  @param f_t2               host time of the reception of the poll
+     *  @param f_t3               host time of the answer
+     *  @param f_t4               board time of the reception of the answer
+     */
+    void CClockSync::update(uint32_t f_t1, uint32_t f_t2, uint32_t f_t3, uint32_t f_t4)
+    {
+        int32_t l_delay = (int32_t)((f_t4 - f_t1) - (f_t3 - f_t2));
+        if(l_delay < 0) l_delay = 0;
+
+        uint32_t l_forward = f_t2 - f_t1;
+        uint32_t l_backward = f_t3 - f_t4;
+        uint32_t l_offset = l_forward + (uint32_t)((int32_t)(l_backward - l_forward) / 2);
+        uint32_t l_time = f_t1 + (f_t4 - f_t1) / 2; // board time of the offset
+
+        if(m_samples > 0)
+        {
+            // The minimum delay ages, so the filter follows the slower links too
+            m_minDelay += m_minDelay / 16 + 1;
+            if((uint32_t)l_delay < m_minDelay) m_minDelay = l_delay;
+            if((uint32_t)l_delay > 2 * m_minDelay + delay_margin_us) return;
+
+            int32_t l_elapsed = (int32_t)(l_time - m_refTime);
+            if(l_elapsed <= 0) return;
+
+            uint32_t l_predicted = m_refOffset + (uint32_t)(int32_t)((int64_t)m_drift * l_elapsed / ppb_scale);
+            int32_t l_error = (int32_t)(l_offset - l_predicted);
+            if((l_error < max_step_us) && (l_error > -max_step_us))
+            {
+                int64_t l_drift = m_drift + (int64_t)l_error * ppb_scale / l_elapsed / 16;
+                if(l_drift > max_drift_ppb) l_drift = max_drift_ppb;
+                if(l_drift < -max_drift_ppb) l_drift = -max_drift_ppb;
+                m_drift = (int32_t)l_drift;
+                m_refOffset = l_predicted + (uint32_t)(l_error / 4);
+                m_refTime = l_time;
+
+                int32_t l_absError = (l_error < 0) ? -l_error : l_error;
+                m_quality = (uint32_t)((int32_t)m_quality + (l_absError - (int32_t)m_quality) / 8);
+                if(m_samples < UINT32_MAX) m_samples++;
+                return;
+            }
+        }
+
+        // (Re)start of the estimation, the error of the first offset is bounded by the half of the delay
+        m_samples = 1;
+        m_refTime = l_time;
+        m_refOffset = l_offset;
+        m_drift = 0;
+        m_minDelay = l_delay;
+        m_quality = l_delay / 2;
+    }
+
+    /** \brief  Periodically sends the polls of the synchronisation
+     *
+     *  The poll without answer is replaced by the next one.
+     */
+    void CClockSync::_run()
+    {
+        if(0 == m_pollCycles) return;
+        if(--m_pollCounter > 0) return;
+        m_pollCounter = m_pollCycles;
+
+        char buffer[_32_chars];
+        utils::CTextFormatter l_text(buffer, sizeof(buffer));
+        m_pollTime = us_ticker_read();
+        m_pollPending = true;
+
+        if(m_serial.isBinaryMode())
+        {
+            l_text.appendUnsigned(m_pollTime);
+            m_serial.writeFrame(drivers::CSerialTransmitter::ID_SYNC, buffer, l_text.length());
+        }
+        else
+        {
+            l_text.append("@sync:").appendUnsigned(m_pollTime).append(";;\r\n");
+            m_serial.write(buffer, l_text.length(), drivers::CSerialTransmitter::ID_SYNC);
+        }
+    }
+
+}; // namespace periodics
\ No newline at end of file
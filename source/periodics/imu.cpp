@@ -32,12 +32,65 @@
 #include <periodics/imu.hpp>
 #include "imu.hpp"
 
+#define _32_chars                       32
 #define _100_chars                      100
+#define _512_chars                      512
 #define BNO055_EULER_DIV_DEG_int        16
 #define BNO055_LINEAR_ACCEL_DIV_MSQ_int 100
 #define precision_scaling_factor        1000
+#define imu_min_sampling_period_ms      10 // the fusion output rate of the sensor is 100Hz
+#define imu_max_stream_period_ms        1000
+#define imu_stationary_reset_us         1500000 // the velocity is reset after 1.5s of stationary readings
 
 namespace periodics{
+    /** \brief  Saturates the value to the range of the 16-bit signed integers */
+    static inline int16_t saturateS16(s32 f_value)
+    {
+        return (int16_t)((f_value > INT16_MAX) ? INT16_MAX : ((f_value < INT16_MIN) ? INT16_MIN : f_value));
+    }
+
+    /** \brief  Angles of the CORDIC rotations, atan(2^-i) in millidegrees */
+    static const int32_t s_cordicAngles[imu_cordic_iterations] = {45000, 26565, 14036, 7125, 3576, 1790, 895, 448, 224, 112, 56, 28, 14, 7, 3, 2};
+
+    /** \brief  Fixed-point atan2 by CORDIC vectoring, in millidegrees from -180000 to 180000
+     *
+     * The error is about 0.01 degree, when the magnitude of the vector is above 2^16. The magnitude grows by 1.65 
+     * during the rotations, so it has to stay below 2^29.
+     */
+    static int32_t atan2Mdeg(int32_t f_y, int32_t f_x)
+    {
+        int32_t l_x = f_x;
+        int32_t l_y = f_y;
+        int32_t l_angle = 0;
+
+        // The rotations converge in the right half-plane, the left one is rotated by 90 degrees
+        if(l_x < 0)
+        {
+            if(l_y >= 0) { l_x = f_y;  l_y = -f_x; l_angle = 90000; }
+            else         { l_x = -f_y; l_y = f_x;  l_angle = -90000; }
+        }
+        for(uint8_t i = 0; i < imu_cordic_iterations; i++)
+        {
+            int32_t l_dx = l_y >> i;
+            int32_t l_dy = l_x >> i;
+            if(l_y > 0) { l_x += l_dx; l_y -= l_dy; l_angle += s_cordicAngles[i]; }
+            else        { l_x -= l_dx; l_y += l_dy; l_angle -= s_cordicAngles[i]; }
+        }
+        if(l_angle > 180000) l_angle -= 360000;
+        if(l_angle <= -180000) l_angle += 360000;
+        return l_angle;
+    }
+
+    /** \brief  Yaw of the Q14 quaternion in millidegrees, atan2(2(wz+xy), 1-2(y^2+z^2)) without floats
+     */
+    static int32_t quaternionYawMdeg(const struct bno055_quaternion_t& f_quaternion)
+    {
+        // The products of the Q14 components are Q28, they're reduced to Q24 for the range of the CORDIC
+        int32_t l_sin = 2 * ((s32)f_quaternion.w * f_quaternion.z + (s32)f_quaternion.x * f_quaternion.y);
+        int32_t l_cos = (1L << 28) - 2 * ((s32)f_quaternion.y * f_quaternion.y + (s32)f_quaternion.z * f_quaternion.z);
+        return atan2Mdeg(l_sin >> 4, l_cos >> 4);
+    }
+
     /** \brief  Class constructor
      *
      *  It initializes the task and the state of the led. 
@@ -54,22 +107,41 @@ namespace periodics{
 
     CImu::CImu(
             std::chrono::milliseconds    f_period, 
-            UnbufferedSerial& f_serial,
+            drivers::CSerialTransmitter& f_serial,
             PinName SDA,
             PinName SCL)
         : utils::CTask(f_period)
         , m_isActive(false)
+        , m_isSampling(false)
+        , m_sample()
         , m_serial(f_serial)
         , m_velocityX(0)
         , m_velocityY(0)
         , m_velocityZ(0)
-        , m_velocityStationaryCounter(0)
+        , m_isStationary(false)
+        , m_stationaryStart(0)
         , m_delta_time(f_period.count())
+        , m_samplingPeriod(0)
+        , m_messageElapsed(0)
+        , m_streamPeriod(0)
+        , m_streamBatch(1)
+        , m_streamElapsed(0)
+        , m_streamSequence(0)
+        , m_stream()
+        , m_i2c(SDA, SCL, 400000, mbed::callback(this, &CImu::i2cWakeup))
+        , m_fusionRaw()
+        , m_reading(false)
+        , m_readTime(0)
+        , m_quatMode(0)
+        , m_lastYaw(0)
+        , m_lastYawTime(0)
+        , m_lastYawValid(false)
     {
-        if(m_delta_time < 150){
-            setNewPeriod(150);
-            m_delta_time = 150;
+        if(m_delta_time < imu_min_sampling_period_ms){
+            setNewPeriod(imu_min_sampling_period_ms);
+            m_delta_time = imu_min_sampling_period_ms;
         }
+        m_defaultPeriod = (uint16_t)m_delta_time;
         
         s32 comres = BNO055_ERROR;
         /* variable used to set the power mode of the sensor*/
@@ -82,8 +154,7 @@ namespace periodics{
         /*--------------------------------------------------------------------------------------------------*
         *  i2c_instance variable member will be initialized with the actual I2C of the target board.
         *---------------------------------------------------------------------------------------------------*/      
-        i2c_instance = new I2C(SDA, SCL);
-        i2c_instance->frequency(400000);
+        i2c_instance = &m_i2c.getBus(); // the blocking accesses of the initialization, the engine is idle
 
         ThisThread::sleep_for(chrono::milliseconds(300));
 
@@ -188,11 +259,7 @@ namespace periodics{
         /* set the power mode as SUSPEND*/
         comres += bno055_set_power_mode(power_mode);
 
-        if(i2c_instance != nullptr)
-        {
-            delete i2c_instance;
-            i2c_instance = nullptr;
-        }
+        i2c_instance = nullptr; // the bus is owned by the engine
         /*---------------------------------------------------------------------*
         ************************* END DE-INITIALIZATION **********************
         *---------------------------------------------------------------------*/
@@ -208,9 +275,9 @@ namespace periodics{
      */
     void CImu::serialCallbackIMUcommand(char const * a, char * b) {
         uint8_t l_isActivate=0;
-        uint8_t l_res = sscanf(a,"%hhu",&l_isActivate);
+        utils::CTextParser l_parser(a);
 
-        if(1 == l_res){
+        if(l_parser.nextAs<uint8_t>(l_isActivate, 0, UINT8_MAX)){
             if(uint8_globalsV_value_of_kl == 15 || uint8_globalsV_value_of_kl == 30)
             {
                 m_isActive=(l_isActivate>=1);
@@ -226,6 +293,183 @@ namespace periodics{
         }
     }
 
+    /** \brief  Serial callback method to select the orientation of the messages
+     *
+     * The message contains the mode: 0 the Euler angles, 1 the quaternion, 2 the quaternion with the yaw and the yaw rate. 
+     * The response is the applied mode.
+     *
+     * @param a                   input received string
+     * @param b                   output reponse message
+     */
+    void CImu::serialCallbackIMUQUATcommand(char const * a, char * b)
+    {
+        uint8_t l_mode = 0;
+        utils::CTextParser l_parser(a);
+
+        if(!l_parser.nextAs<uint8_t>(l_mode, 0, 2))
+        {
+            sprintf(b,"syntax error");
+            return;
+        }
+        if(uint8_globalsV_value_of_kl != 15 && uint8_globalsV_value_of_kl != 30)
+        {
+            sprintf(b,"kl 15/30 is required!!");
+            return;
+        }
+
+        m_quatMode = l_mode;
+        m_lastYawValid = false; // the yaw rate restarts from the next message
+
+        utils::CTextFormatter l_text(b, _32_chars);
+        l_text.appendUnsigned(m_quatMode);
+    }
+
+    /** \brief  Serial callback method to start or stop the high-rate stream
+     *
+     * The message contains the sampling period in milliseconds and the number of the samples in a batch ("10;2"), the zero period 
+     * stops the stream. The period is rounded up to the output rate of the sensor. The response is the applied period and batch.
+     *
+     * @param a                   input received string
+     * @param b                   output reponse message
+     */
+    void CImu::serialCallbackIMUSTREAMcommand(char const * a, char * b)
+    {
+        uint16_t l_period = 0;
+        uint8_t l_batch = 0;
+        utils::CTextParser l_parser(a);
+
+        if(!l_parser.nextAs<uint16_t>(l_period, 0, imu_max_stream_period_ms) || !l_parser.nextAs<uint8_t>(l_batch, 1, imu_max_batch))
+        {
+            sprintf(b,"syntax error");
+            return;
+        }
+        if(uint8_globalsV_value_of_kl != 15 && uint8_globalsV_value_of_kl != 30)
+        {
+            sprintf(b,"kl 15/30 is required!!");
+            return;
+        }
+
+        m_streamPeriod = ((l_period > 0) && (l_period < imu_min_sampling_period_ms)) ? imu_min_sampling_period_ms : l_period;
+        m_streamBatch = l_batch;
+        m_streamElapsed = m_streamPeriod; // the first sample is taken at the next run
+        SImuStreamSample l_sample;
+        while(m_stream.pop(l_sample)) {} // the samples of the previous stream are dropped
+        updatePeriod();
+
+        utils::CTextFormatter l_text(b, _32_chars);
+        l_text.appendUnsigned(m_streamPeriod).appendChar(';').appendUnsigned(m_streamBatch);
+    }
+
+    /** \brief  Keeps the sensor sampled also when the messages of the task are disabled, e.g. for the telemetry
+     *
+     * The period of the task is decreased to the requested sampling period, but not below the output rate of the sensor, 
+     * the messages of the task keep the period given in the constructor. Zero stops the sampling.
+     *
+     * @param f_period            sampling period in milliseconds, zero for stopping the sampling
+     */
+    void CImu::setSamplingPeriod(uint16_t f_period)
+    {
+        m_samplingPeriod = f_period;
+        updatePeriod();
+    }
+
+    /** \brief  Applies the shortest period of the messages, of the sampling request and of the stream
+     */
+    void CImu::updatePeriod()
+    {
+        m_isSampling = (m_samplingPeriod > 0) || (m_streamPeriod > 0);
+
+        uint16_t l_period = m_defaultPeriod;
+        if((m_samplingPeriod > 0) && (m_samplingPeriod < l_period)) l_period = m_samplingPeriod;
+        if((m_streamPeriod > 0) && (m_streamPeriod < l_period)) l_period = m_streamPeriod;
+        if(l_period < imu_min_sampling_period_ms) l_period = imu_min_sampling_period_ms;
+
+        m_delta_time = l_period; // the velocity is integrated over the period
+        setNewPeriod(l_period);
+    }
+
+    /** \brief  Stores the sample in the stream, with the period of the stream
+     *
+     * The oldest sample is overwritten, when the buffer is full.
+     *
+     * @param f_fusion            values read from the sensor
+     */
+    void CImu::pushStream(const struct bno055_fusion_t& f_fusion)
+    {
+        m_streamElapsed += (uint16_t)m_delta_time;
+        if(m_streamElapsed < m_streamPeriod) return;
+        m_streamElapsed -= m_streamPeriod;
+        if(m_streamElapsed >= m_streamPeriod) m_streamElapsed = 0; // the task was slower than the stream
+
+        SImuStreamSample l_sample;
+        if(m_stream.isFull()) m_stream.pop(l_sample);
+
+        l_sample.sequence = m_streamSequence++;
+        l_sample.time = m_readTime;
+        l_sample.heading = f_fusion.euler.h;
+        l_sample.roll = f_fusion.euler.r;
+        l_sample.pitch = f_fusion.euler.p;
+        l_sample.accelX = f_fusion.linear_accel.x;
+        l_sample.accelY = f_fusion.linear_accel.y;
+        l_sample.accelZ = f_fusion.linear_accel.z;
+        m_stream.push(l_sample);
+    }
+
+    /** \brief  Sends a batch of the stream in one message
+     *
+     * The batch is dropped, when the serial link rejects it.
+     */
+    void CImu::sendStream()
+    {
+        SImuStreamSample l_batch[imu_max_batch];
+        uint32_t l_count = m_stream.pop(l_batch, m_streamBatch);
+        if(0 == l_count) return;
+
+        if(m_serial.isBinaryMode())
+        {
+            uint8_t l_payload[11 + imu_max_batch * 12];
+            uint8_t* l_it = utils::CBinaryFrame::putU32(l_payload, l_batch[0].sequence);
+            l_it = utils::CBinaryFrame::putU32(l_it, l_batch[0].time);
+            l_it = utils::CBinaryFrame::putU16(l_it, m_streamPeriod);
+            *l_it++ = (uint8_t)l_count;
+            for(uint32_t i = 0; i < l_count; i++)
+            {
+                l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)l_batch[i].heading);
+                l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)l_batch[i].roll);
+                l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)l_batch[i].pitch);
+                l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)l_batch[i].accelX);
+                l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)l_batch[i].accelY);
+                l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)l_batch[i].accelZ);
+            }
+            m_serial.writeFrame(drivers::CSerialTransmitter::ID_IMU_STREAM, l_payload, l_it - l_payload, drivers::CSerialTransmitter::PRIORITY_TELEMETRY);
+            return;
+        }
+
+        char buffer[_512_chars];
+        utils::CTextFormatter l_text(buffer, sizeof(buffer));
+        l_text.append("@imuStream:").appendUnsigned(l_batch[0].sequence).appendChar(';').appendUnsigned(l_batch[0].time)
+              .appendChar(';').appendUnsigned(m_streamPeriod).appendChar(';').appendUnsigned(l_count);
+        for(uint32_t i = 0; i < l_count; i++)
+        {
+            // The angles are scaled by 1000, they are written with three decimals, the accelerations are in 1/100 m/s^2
+            l_text.appendChar(';').appendFixed((l_batch[i].heading * precision_scaling_factor) / BNO055_EULER_DIV_DEG_int, 3)
+                  .appendChar(';').appendFixed((l_batch[i].roll * precision_scaling_factor) / BNO055_EULER_DIV_DEG_int, 3)
+                  .appendChar(';').appendFixed((l_batch[i].pitch * precision_scaling_factor) / BNO055_EULER_DIV_DEG_int, 3)
+                  .appendChar(';').appendFixed(l_batch[i].accelX, 2)
+                  .appendChar(';').appendFixed(l_batch[i].accelY, 2)
+                  .appendChar(';').appendFixed(l_batch[i].accelZ, 2);
+        }
+        l_text.append(";;\r\n");
+        m_serial.write(buffer, l_text.length(), drivers::CSerialTransmitter::ID_IMU_STREAM, drivers::CSerialTransmitter::PRIORITY_TELEMETRY);
+    }
+
+    /** \brief  Latest sample of the sensor, it's updated at each run of the task, while the task is active or sampling
+     */
+    const SImuSample& CImu::getSample()
+    {
+        return m_sample;
+    }
+
     /* This API is an example for reading sensor data
     *  \param: None
     *  \return: communication result
@@ -631,8 +875,8 @@ namespace periodics{
             *(reg_data + stringpos) = array[stringpos];
         }
 
-        // Write the register address to set the pointer for reading
-        if (i2c_instance->write(dev_addr, (const char*)&reg_addr, 1) != 0)
+        // Write the register address to set the pointer for reading, the read follows with a repeated start in the same transaction
+        if (i2c_instance->write(dev_addr, (const char*)&reg_addr, 1, true) != 0)
         {
             BNO055_iERROR = BNO055_ERROR; // Return error (-1)
             return (s8)BNO055_iERROR;
@@ -659,8 +903,10 @@ namespace periodics{
      *--------------------------------------------------------------------------*/
     void CImu::I2C_routine(void)
     {
-        bno055.bus_write = BNO055_I2C_bus_write;
-        bno055.bus_read = BNO055_I2C_bus_read;
+        // The accesses of the driver pass through the register shadow, which skips the redundant ones
+        drivers::CBno055Shadow::attach(BNO055_I2C_bus_write, BNO055_I2C_bus_read);
+        bno055.bus_write = drivers::CBno055Shadow::busWrite;
+        bno055.bus_read = drivers::CBno055Shadow::busRead;
         bno055.delay_msec = BNO055_delay_msek;
         bno055.dev_addr = BNO055_I2C_ADDR2 << 1;
         // bno055.dev_addr = BNO055_I2C_ADDR1 << 1;
@@ -682,62 +928,107 @@ namespace periodics{
         ThisThread::sleep_for(chrono::milliseconds(msek));
     }
 
-    /** 
-    * \brief  Periodically retrieves and processes IMU sensor values.
-    * 
-    * This method is invoked periodically and handles:
-    * 1. Reading Euler angles (roll, pitch, yaw) from the BNO055 sensor.
-    * 2. Reading linear acceleration values in the x, y, and z axes from the sensor.
-    * 3. Based on the linear acceleration, it updates the current velocity of the device.
-    * 4. If the device appears to be stationary (based on x and y acceleration thresholds), 
-    *    a counter is incremented. If the device remains stationary for a certain duration 
-    *    (15 cycles in this case), the velocity is reset.
-    * 5. Formats and sends the acquired data over a serial connection.
-    * 
-    * \note If there are any issues reading from the BNO055 sensor, the method will exit early without sending data.
-    */
-    void CImu::_run()
+    /** \brief  Wakeup callback of the I2C engine, it's applied from interrupt context at the end of a transaction
+     */
+    void CImu::i2cWakeup()
     {
-        if(!m_isActive) return;
-        
-        char buffer[_100_chars];
-        s8 comres = BNO055_SUCCESS;
-
-        s16 s16_euler_h_raw = BNO055_INIT_VALUE;
-        s16 s16_euler_p_raw = BNO055_INIT_VALUE;
-        s16 s16_euler_r_raw = BNO055_INIT_VALUE;
-
-        s16 s16_linear_accel_x_raw = BNO055_INIT_VALUE;
-        s16 s16_linear_accel_y_raw = BNO055_INIT_VALUE;
-        s16 s16_linear_accel_z_raw = BNO055_INIT_VALUE;
+        notify();
+    }
 
-        comres += bno055_read_euler_h(&s16_euler_h_raw);
+    /** \brief  Run method of the task, the state machine of the sampling
+     *
+     * The periodic run starts the burst read of the fusion data (registers 0x1A to 0x33) in background, the completion of the 
+     * read notifies the task, the sample is processed in the next run. The task never waits for the bus.
+     */
+    void CImu::_run()
+    {
+        m_i2c.process(); // The completed read is processed by fusionReadCallback
 
-        if(comres != BNO055_SUCCESS) return;
+        if(!m_isActive && !m_isSampling) return;
+        if(m_reading) return;
 
-        comres += bno055_read_euler_p(&s16_euler_p_raw);
+        // The runs of the notifications are between the periodic runs
+        uint32_t l_now = us_ticker_read();
+        if(l_now - m_readTime < (uint32_t)m_delta_time * 500) return;
 
-        if(comres != BNO055_SUCCESS) return;
+        // The fusion data is on the page zero, the page is changed only while the engine is idle
+        if((bno055.page_id != BNO055_PAGE_ZERO) && (bno055_write_page_id(BNO055_PAGE_ZERO) != BNO055_SUCCESS)) return;
 
-        comres += bno055_read_euler_r(&s16_euler_r_raw);
+        const uint8_t l_register = BNO055_EULER_H_LSB_ADDR;
+        if(m_i2c.submit(bno055.dev_addr, &l_register, 1, m_fusionRaw, BNO055_FUSION_DATA_SIZE, mbed::callback(this, &CImu::fusionReadCallback)))
+        {
+            m_reading = true;
+            m_readTime = l_now;
+        }
+    }
 
-        if(comres != BNO055_SUCCESS) return;
+    /** \brief  Completion of the burst read of the fusion data
+     *
+     * @param f_result            zero for success
+     */
+    void CImu::fusionReadCallback(int f_result)
+    {
+        m_reading = false;
+        if(f_result != 0) return;
 
-        s32 s32_euler_h_deg = (s16_euler_h_raw * precision_scaling_factor) / BNO055_EULER_DIV_DEG_int;
-        s32 s32_euler_p_deg = (s16_euler_p_raw * precision_scaling_factor) / BNO055_EULER_DIV_DEG_int;
-        s32 s32_euler_r_deg = (s16_euler_r_raw * precision_scaling_factor) / BNO055_EULER_DIV_DEG_int;
+        struct bno055_fusion_t l_fusion;
+        bno055_decode_fusion_data(m_fusionRaw, &l_fusion);
+        processSample(l_fusion);
+    }
 
-        comres = bno055_read_linear_accel_x(&s16_linear_accel_x_raw);
+    /** \brief  Serial callback method to report the latency of the I2C transactions
+     *
+     * The response is "COUNT;ERRORS;LAST;MAX;MEAN;BUS_READS;BUS_WRITES;CACHED;SKIPPED", the latencies in microseconds. The first 
+     * part is about the background transactions, the second one about the accesses of the driver: the reads and the writes made 
+     * on the bus, the reads served by the register shadow and the skipped writes. The statistics are cleared after the report.
+     *
+     * @param a                   input received string
+     * @param b                   output reponse message
+     */
+    void CImu::serialCallbackI2Ccommand(char const * a, char * b)
+    {
+        uint8_t l_request = 0;
+        utils::CTextParser l_parser(a);
+        if(!l_parser.nextAs<uint8_t>(l_request, 0, UINT8_MAX))
+        {
+            sprintf(b,"syntax error");
+            return;
+        }
 
-        if(comres != BNO055_SUCCESS) return;
+        const drivers::CI2CEngine::SStats& l_stats = m_i2c.getStats();
+        utils::CTextFormatter l_text(b, _100_chars);
+        l_text.appendUnsigned(l_stats.count).appendChar(';').appendUnsigned(l_stats.errors).appendChar(';').appendUnsigned(l_stats.latencyLast)
+              .appendChar(';').appendUnsigned(l_stats.latencyMax).appendChar(';').appendUnsigned((l_stats.count > 0) ? (uint32_t)(l_stats.latencySum / l_stats.count) : 0);
+        const drivers::CBno055Shadow::SStats& l_shadow = drivers::CBno055Shadow::getStats();
+        l_text.appendChar(';').appendUnsigned(l_shadow.reads).appendChar(';').appendUnsigned(l_shadow.writes)
+              .appendChar(';').appendUnsigned(l_shadow.cachedReads).appendChar(';').appendUnsigned(l_shadow.skippedWrites);
+        m_i2c.resetStats();
+        drivers::CBno055Shadow::resetStats();
+    }
 
-        comres = bno055_read_linear_accel_y(&s16_linear_accel_y_raw);
+    /** \brief  Processes a sample: the velocity, the latest sample, the stream and the messages
+     *
+     * The velocity is integrated from the linear acceleration. While the x and y accelerations stay within 0.11 m/s^2, the device 
+     * is considered stationary. The velocity is reset after 1.5s of stationary readings, measured between the times of the readings, 
+     * so the window doesn't depend on the sampling period.
+     *
+     * @param f_fusion            values read from the sensor
+     */
+    void CImu::processSample(const struct bno055_fusion_t& f_fusion)
+    {
+        char buffer[_100_chars];
 
-        if(comres != BNO055_SUCCESS) return;
+        s16 s16_euler_h_raw = f_fusion.euler.h;
+        s16 s16_euler_p_raw = f_fusion.euler.p;
+        s16 s16_euler_r_raw = f_fusion.euler.r;
 
-        comres = bno055_read_linear_accel_z(&s16_linear_accel_z_raw);
+        s16 s16_linear_accel_x_raw = f_fusion.linear_accel.x;
+        s16 s16_linear_accel_y_raw = f_fusion.linear_accel.y;
+        s16 s16_linear_accel_z_raw = f_fusion.linear_accel.z;
 
-        if(comres != BNO055_SUCCESS) return;
+        s32 s32_euler_h_deg = (s16_euler_h_raw * precision_scaling_factor) / BNO055_EULER_DIV_DEG_int;
+        s32 s32_euler_p_deg = (s16_euler_p_raw * precision_scaling_factor) / BNO055_EULER_DIV_DEG_int;
+        s32 s32_euler_r_deg = (s16_euler_r_raw * precision_scaling_factor) / BNO055_EULER_DIV_DEG_int;
 
         s32 s16_linear_accel_x_msq = (s16_linear_accel_x_raw * precision_scaling_factor) / BNO055_LINEAR_ACCEL_DIV_MSQ_int;
         s32 s16_linear_accel_y_msq = (s16_linear_accel_y_raw * precision_scaling_factor) / BNO055_LINEAR_ACCEL_DIV_MSQ_int;
@@ -748,13 +1039,17 @@ namespace periodics{
             m_velocityX += 0 * m_delta_time; // Δt = m_delta_time
             m_velocityY += 0 * m_delta_time;
             m_velocityZ += 0 * m_delta_time;
-            m_velocityStationaryCounter += 1;
-            if (m_velocityStationaryCounter == 10)
+            if (!m_isStationary)
+            {
+                m_isStationary = true;
+                m_stationaryStart = m_readTime;
+            }
+            else if (m_readTime - m_stationaryStart >= imu_stationary_reset_us)
             {
                 m_velocityX = 0;
                 m_velocityY = 0;
                 m_velocityZ = 0;
-                m_velocityStationaryCounter = 0;
+                m_stationaryStart = m_readTime;
             }
             
         }
@@ -762,19 +1057,116 @@ namespace periodics{
             m_velocityX += (s16_linear_accel_x_msq * (uint16_t)m_delta_time) / 1000; // Δt = m_delta_time
             m_velocityY += (s16_linear_accel_y_msq * (uint16_t)m_delta_time) / 1000;
             m_velocityZ += (s16_linear_accel_z_msq * (uint16_t)m_delta_time) / 1000;
-            m_velocityStationaryCounter = 0;
+            m_isStationary = false;
         }
 
-        if(comres != BNO055_SUCCESS) return;
+        m_sample.sequence++;
+        m_sample.roll = s32_euler_r_deg;
+        m_sample.pitch = s32_euler_p_deg;
+        m_sample.heading = s32_euler_h_deg;
+        m_sample.velocityX = m_velocityX;
+        m_sample.velocityY = m_velocityY;
+        m_sample.velocityZ = m_velocityZ;
+
+        if(m_streamPeriod > 0)
+        {
+            pushStream(f_fusion);
+            if(m_stream.getSize() >= m_streamBatch) sendStream();
+        }
+
+        if(!m_isActive) return;
+
+        // The messages keep the period given in the constructor, also when the sensor is sampled faster
+        m_messageElapsed += (uint16_t)m_delta_time;
+        if(m_messageElapsed < m_defaultPeriod) return;
+        m_messageElapsed = 0;
+
+        if(m_quatMode > 0)
+        {
+            sendQuaternion(f_fusion.quaternion);
+            return;
+        }
+
+        if(m_serial.isBinaryMode())
+        {
+            // Euler angles (roll, pitch, heading) in the raw unit of the sensor (1/16 degree) and the velocities in mm/s
+            uint8_t l_payload[12];
+            uint8_t* l_it = l_payload;
+            l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)s16_euler_r_raw);
+            l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)s16_euler_p_raw);
+            l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)s16_euler_h_raw);
+            l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)saturateS16(m_velocityX));
+            l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)saturateS16(m_velocityY));
+            l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)saturateS16(m_velocityZ));
+            m_serial.writeFrame(drivers::CSerialTransmitter::ID_IMU, l_payload, sizeof(l_payload), drivers::CSerialTransmitter::PRIORITY_TELEMETRY);
+            return;
+        }
 
-        snprintf(buffer, sizeof(buffer), "@imu:%d.%03d;%d.%03d;%d.%03d;%d.%03d;%d.%03d;%d.%03d;;\r\n",
-            s32_euler_r_deg/1000, abs(s32_euler_r_deg%1000),
-            s32_euler_p_deg/1000, abs(s32_euler_p_deg%1000),
-            s32_euler_h_deg/1000, abs(s32_euler_h_deg%1000),
-            m_velocityX/1000, abs(m_velocityX%1000),
-            m_velocityY/1000, abs(m_velocityY%1000),
-            m_velocityZ/1000, abs(m_velocityZ%1000));
-        m_serial.write(buffer,strlen(buffer));
+        // The values are scaled by 1000, they are written with three decimals
+        utils::CTextFormatter l_text(buffer, sizeof(buffer));
+        l_text.append("@imu:").appendFixed(s32_euler_r_deg, 3).appendChar(';')
+                              .appendFixed(s32_euler_p_deg, 3).appendChar(';')
+                              .appendFixed(s32_euler_h_deg, 3).appendChar(';')
+                              .appendFixed(m_velocityX, 3).appendChar(';')
+                              .appendFixed(m_velocityY, 3).appendChar(';')
+                              .appendFixed(m_velocityZ, 3).append(";;\r\n");
+        m_serial.write(buffer, l_text.length(), drivers::CSerialTransmitter::ID_IMU, drivers::CSerialTransmitter::PRIORITY_TELEMETRY);
+    }
+
+    /** \brief  Sends the quaternion message, in mode 2 with the yaw and the yaw rate
+     *
+     * The yaw rate is the change of the yaw since the previous message over the time between the readings.
+     *
+     * @param f_quaternion        quaternion read from the sensor, Q14
+     */
+    void CImu::sendQuaternion(const struct bno055_quaternion_t& f_quaternion)
+    {
+        char buffer[_100_chars];
+        int32_t l_yaw = 0;
+        int32_t l_yawRate = 0;
+
+        if(m_quatMode > 1)
+        {
+            l_yaw = quaternionYawMdeg(f_quaternion);
+            uint32_t l_elapsed = m_readTime - m_lastYawTime;
+            if(m_lastYawValid && (l_elapsed > 0))
+            {
+                int32_t l_change = l_yaw - m_lastYaw;
+                if(l_change > 180000) l_change -= 360000; // the shortest way around the wrap
+                if(l_change < -180000) l_change += 360000;
+                l_yawRate = (int32_t)(((int64_t)l_change * 1000000) / l_elapsed);
+            }
+            m_lastYaw = l_yaw;
+            m_lastYawTime = m_readTime;
+            m_lastYawValid = true;
+        }
+
+        if(m_serial.isBinaryMode())
+        {
+            uint8_t l_payload[16];
+            uint8_t* l_it = l_payload;
+            l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)f_quaternion.w);
+            l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)f_quaternion.x);
+            l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)f_quaternion.y);
+            l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)f_quaternion.z);
+            if(m_quatMode > 1)
+            {
+                l_it = utils::CBinaryFrame::putU32(l_it, (uint32_t)l_yaw);
+                l_it = utils::CBinaryFrame::putU32(l_it, (uint32_t)l_yawRate);
+            }
+            m_serial.writeFrame(drivers::CSerialTransmitter::ID_IMU_QUAT, l_payload, l_it - l_payload, drivers::CSerialTransmitter::PRIORITY_TELEMETRY);
+            return;
+        }
+
+        utils::CTextFormatter l_text(buffer, sizeof(buffer));
+        l_text.append("@imuQuat:").appendSigned(f_quaternion.w).appendChar(';').appendSigned(f_quaternion.x)
+              .appendChar(';').appendSigned(f_quaternion.y).appendChar(';').appendSigned(f_quaternion.z);
+        if(m_quatMode > 1)
+        {
+            l_text.appendChar(';').appendFixed(l_yaw, 3).appendChar(';').appendFixed(l_yawRate, 3);
+        }
+        l_text.append(";;\r\n");
+        m_serial.write(buffer, l_text.length(), drivers::CSerialTransmitter::ID_IMU_QUAT, drivers::CSerialTransmitter::PRIORITY_TELEMETRY);
     }
 
 }; // namespace periodics
\ No newline at end of file
@@ -46,7 +46,7 @@ namespace periodics{
     CInstantConsumption::CInstantConsumption(
             std::chrono::milliseconds        f_period, 
             mbed::AnalogIn  f_pin, 
-            UnbufferedSerial&      f_serial) 
+            drivers::CSerialTransmitter& f_serial) 
         : utils::CTask(f_period)
         , m_pin(f_pin)
         , m_isActive(false)
@@ -72,9 +72,9 @@ namespace periodics{
      */
     void CInstantConsumption::serialCallbackINSTANTcommand(char const * a, char * b) {
         uint8_t l_isActivate=0;
-        uint8_t l_res = sscanf(a,"%hhu",&l_isActivate);
+        utils::CTextParser l_parser(a);
 
-        if(1 == l_res){
+        if(l_parser.nextAs<uint8_t>(l_isActivate, 0, UINT8_MAX)){
             if(uint8_globalsV_value_of_kl == 15 || uint8_globalsV_value_of_kl == 30)
             {
                 m_isActive=(l_isActivate>=1);
@@ -151,6 +151,13 @@ namespace periodics{
         uint32_globalsV_numberOfMiliseconds_Total += task_period;
     }
 
+    /** \brief  Latest exponentially smoothed instant consumption in mA, it's updated by the safety measure
+     */
+    uint32_t CInstantConsumption::getCurrent()
+    {
+        return currentEMA;
+    }
+
     /**
     * @brief Periodically computes and sends the exponentially smoothed instantaneous consumption value over the serial connection.
     * 
@@ -175,10 +182,20 @@ namespace periodics{
     {
         if(!m_isActive) return;
 
+        if(m_serial.isBinaryMode())
+        {
+            // Smoothed instant consumption
+            uint8_t l_payload[4];
+            utils::CBinaryFrame::putU32(l_payload, currentEMA);
+            m_serial.writeFrame(drivers::CSerialTransmitter::ID_INSTANT, l_payload, sizeof(l_payload), drivers::CSerialTransmitter::PRIORITY_TELEMETRY);
+            return;
+        }
+
         char buffer[_24_chars];
 
-        snprintf(buffer, sizeof(buffer), "@instant:%lu;;\r\n", currentEMA);
-        m_serial.write(buffer,strlen(buffer));
+        utils::CTextFormatter l_text(buffer, sizeof(buffer));
+        l_text.append("@instant:").appendUnsigned(currentEMA).append(";;\r\n");
+        m_serial.write(buffer, l_text.length(), drivers::CSerialTransmitter::ID_INSTANT, drivers::CSerialTransmitter::PRIORITY_TELEMETRY);
     }
 
 }; // namespace periodics
\ No newline at end of file
@@ -52,7 +52,7 @@ namespace periodics
     CPowermanager::CPowermanager(
         std::chrono::milliseconds f_period,
         brain::CKlmanager& f_CKlmanager,
-        UnbufferedSerial& f_serial,
+        drivers::CSerialTransmitter& f_serial,
         periodics::CTotalVoltage& f_totalVoltage,
         periodics::CInstantConsumption& f_instantConsumption,
         periodics::CAlerts& f_alerts
@@ -68,6 +68,8 @@ namespace periodics
     , m_shutdownCounter(0)
     {
         /* constructor behaviour */
+        // The consumed charge and the elapsed time are accumulated per run, so the missed activations are applied too.
+        setOverrunPolicy(CATCH_UP);
     }
 
     /** @brief  CPowermanager class destructor
@@ -116,8 +118,9 @@ namespace periodics
 
                     bool_globalsV_warningFlag = !bool_globalsV_warningFlag;
 
-                    snprintf(buffer, sizeof(buffer), "@warning:%hhu:%hhu:%hhu;;\r\n", h, m, s);
-                    m_serial.write(buffer, strlen(buffer));
+                    utils::CTextFormatter l_text(buffer, sizeof(buffer));
+                    l_text.append("@warning:").appendUnsigned(h).appendChar(':').appendUnsigned(m).appendChar(':').appendUnsigned(s).append(";;\r\n");
+                    m_serial.write(buffer, l_text.length());
 
                     m_alerts.alertsCommand("1",buffer);
                 }
@@ -133,8 +136,9 @@ namespace periodics
 
             if(m_shutdownCounter == counter_shutdown)
             {   
-                snprintf(buffer, sizeof(buffer), "@shutdown:ack;;\r\n");
-                m_serial.write(buffer, strlen(buffer));
+                utils::CTextFormatter l_text(buffer, sizeof(buffer));
+                l_text.append("@shutdown:ack;;\r\n");
+                m_serial.write(buffer, l_text.length());
 
                 char buffer2[_1_char];
 
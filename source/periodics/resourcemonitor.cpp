@@ -1,6 +1,7 @@
 #include "periodics/resourcemonitor.hpp"
 
-#define _50_chars 50
+#define _100_chars 100
+#define _150_chars 150
 #define max_percent_int 10000 // 100.00%
 
 // TODO: Add your code here
@@ -10,10 +11,13 @@ namespace periodics
     * @brief Class constructorresourcemonitor
     *
     */
-    CResourcemonitor::CResourcemonitor(std::chrono::milliseconds f_period, UnbufferedSerial& f_serial)
+    CResourcemonitor::CResourcemonitor(std::chrono::milliseconds f_period, drivers::CSerialTransmitter& f_serial, utils::CTaskManager& f_taskManager, drivers::CSerialMonitor& f_serialMonitor)
     : utils::CTask(f_period)
     , m_serial(f_serial)
+    , m_taskManager(f_taskManager)
+    , m_serialMonitor(f_serialMonitor)
     , m_isActive(false)
+    , m_taskStatsActive(false)
     {
         /* constructor behaviour */
     }
@@ -26,9 +30,9 @@ namespace periodics
 
     void CResourcemonitor::serialCallbackRESMONCommand(char const * a, char * b){
         uint8_t l_isActivate=0;
-        uint8_t l_res = sscanf(a,"%hhu",&l_isActivate);
+        utils::CTextParser l_parser(a);
 
-        if(1 == l_res){
+        if(l_parser.nextAs<uint8_t>(l_isActivate, 0, UINT8_MAX)){
             if(uint8_globalsV_value_of_kl == 15 || uint8_globalsV_value_of_kl == 30)
             {
                 m_isActive=(l_isActivate>=1);
@@ -44,11 +48,75 @@ namespace periodics
         }
     }
 
-    void CResourcemonitor::_run(){
-        if(!m_isActive) return;
-        
-        char buffer[_50_chars];
+    /** \brief  Serial callback method to activate or deactivate the task statistics publisher (e.g. "#taskStats:1;;").
+     * The statistics are cleared at the activation and after each report, so every report covers one period of the monitor.
+     *
+     * @param a                   input received string
+     * @param b                   output reponse message
+     * 
+     */
+    void CResourcemonitor::serialCallbackTASKSTATSCommand(char const * a, char * b){
+        uint8_t l_isActivate=0;
+        utils::CTextParser l_parser(a);
+
+        if(l_parser.nextAs<uint8_t>(l_isActivate, 0, UINT8_MAX)){
+            if(uint8_globalsV_value_of_kl == 15 || uint8_globalsV_value_of_kl == 30)
+            {
+                m_taskStatsActive=(l_isActivate>=1);
+                for(uint8_t i = 0; i < m_taskManager.getTaskCount(); i++)
+                {
+                    m_taskManager.getTask(i)->resetStats();
+                }
+                sprintf(b,"1");
+            }
+            else{
+                sprintf(b,"kl 15/30 is required!!");
+            }
+            
+        }else{
+            sprintf(b,"syntax error");
+        }
+    }
 
+    /** \brief  Sends the execution statistics of the tasks, one line per task, in the order of the task list:
+     *
+     *   "@taskStats:INDEX;RUNS;RUN_MIN;RUN_MEAN;RUN_MAX;LATENCY_MEAN;LATENCY_MAX;OVERRUNS;MAX_CONSECUTIVE_OVERRUNS;MISSED;HARD_MISSES;;\r\n"
+     *
+     * The run times are given in CPU cycles, the start latencies from the deadlines in microseconds. The statistics of a task 
+     * are cleared only after its line was queued, so a line rejected under congestion is reported in the next window.
+     */
+    void CResourcemonitor::sendTaskStats(){
+        char buffer[_150_chars];
+
+        for(uint8_t i = 0; i < m_taskManager.getTaskCount(); i++)
+        {
+            utils::CTask* l_task = m_taskManager.getTask(i);
+            const utils::STaskStats& l_stats = l_task->getStats();
+
+            uint32_t l_runMin = (l_stats.runCount > 0) ? l_stats.runMin : 0;
+            uint32_t l_runMean = (l_stats.runCount > 0) ? (uint32_t)(l_stats.runSum / l_stats.runCount) : 0;
+            uint32_t l_latencyMean = (l_stats.runCount > 0) ? (uint32_t)(l_stats.latencySum / l_stats.runCount) : 0;
+
+            utils::CTextFormatter l_text(buffer, sizeof(buffer));
+            l_text.append("@taskStats:").appendUnsigned(i).appendChar(';').appendUnsigned(l_stats.runCount).appendChar(';')
+                  .appendUnsigned(l_runMin).appendChar(';').appendUnsigned(l_runMean).appendChar(';').appendUnsigned(l_stats.runMax).appendChar(';')
+                  .appendUnsigned(l_latencyMean).appendChar(';').appendUnsigned(l_stats.latencyMax).appendChar(';').appendUnsigned(l_stats.overruns).appendChar(';')
+                  .appendUnsigned(l_stats.consecutiveOverrunsMax).appendChar(';').appendUnsigned(l_stats.missed).appendChar(';')
+                  .appendUnsigned(l_stats.hardMisses).append(";;\r\n");
+            // A rejected line keeps the statistics, they are reported in the next window together with the new runs
+            if(m_serial.write(buffer, l_text.length(), drivers::CSerialTransmitter::ID_TASK_STATS, drivers::CSerialTransmitter::PRIORITY_TELEMETRY) > 0)
+            {
+                l_task->resetStats();
+            }
+        }
+    }
+
+    /** \brief  Current usage of the resources: the heap and the stack usage, the idle time of the main loop in the last window 
+     * and the delay of the timed wake-ups in microseconds (max;mean)
+     *
+     * @param f_usage             output usage
+     */
+    void CResourcemonitor::getUsage(SResourceUsage& f_usage){
         mbed_stats_heap_t heap_stats;
         mbed_stats_stack_t stack_stats;
 
@@ -56,12 +124,36 @@ namespace periodics
         mbed_stats_stack_get(&stack_stats);
 
         // Compute the usage percentage
-        uint16_t heap_usage_percentage = (heap_stats.current_size * max_percent_int) / heap_stats.reserved_size;
-        uint16_t stack_usage_percentage = (stack_stats.max_size * max_percent_int) / stack_stats.reserved_size;
+        f_usage.heap = (heap_stats.current_size * max_percent_int) / heap_stats.reserved_size;
+        f_usage.stack = (stack_stats.max_size * max_percent_int) / stack_stats.reserved_size;
+
+        f_usage.idle = m_taskManager.getIdlePercent();
+        f_usage.jitterMax = m_taskManager.getWakeupJitterMax();
+        f_usage.jitterMean = m_taskManager.getWakeupJitterMean();
+    }
+
+    void CResourcemonitor::_run(){
+        if(m_taskStatsActive) sendTaskStats();
+
+        if(!m_isActive) return;
+        
+        char buffer[_150_chars];
+
+        SResourceUsage l_usage;
+        getUsage(l_usage);
 
-        snprintf(buffer, sizeof(buffer), "@resourceMonitor:Heap (%d.%d);Stack (%d.%d);;\r\n", heap_usage_percentage/100, heap_usage_percentage%100,
-                                            stack_usage_percentage/100, stack_usage_percentage%100);
-        m_serial.write(buffer,strlen(buffer));
+        // Maximum depth of the transmit queue since the last report and the number of the dropped characters (max;dropped), 
+        // the received characters lost in the full buffer and the line errors (overflows;errors)
+        // The percentages are given in hundredths of percent
+        utils::CTextFormatter l_text(buffer, sizeof(buffer));
+        l_text.append("@resourceMonitor:Heap (").appendFixed(l_usage.heap, 2).append(");Stack (").appendFixed(l_usage.stack, 2)
+              .append(");Idle (").appendFixed(l_usage.idle, 2)
+              .append(");Jitter (").appendUnsigned(l_usage.jitterMax).appendChar(';').appendUnsigned(l_usage.jitterMean)
+              .append(");Tx (").appendUnsigned(m_serial.getQueueMax()).appendChar(';').appendUnsigned(m_serial.getDropped())
+              .append(");Rx (").appendUnsigned(m_serialMonitor.getReceiver().getOverflows()).appendChar(';').appendUnsigned(m_serialMonitor.getReceiver().getErrors())
+              .append(");;\r\n");
+        m_serial.write(buffer, l_text.length(), drivers::CSerialTransmitter::ID_RESOURCE_MONITOR, drivers::CSerialTransmitter::PRIORITY_TELEMETRY);
+        m_serial.resetQueueMax();
     }
 
 }; // namespace periodics
\ No newline at end of file
@@ -0,0 +1,416 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+#include <periodics/telemetry.hpp>
+
+#define _48_chars 48
+#define _100_chars 100
+#define _200_chars 200
+#define telemetry_payload_size 49
+#define max_topic_period_ms 60000
+#define slowdown_interval_ms 1000
+#define idle_period_ms 1000
+
+namespace periodics{
+    /** @brief  Keys of the topics in the subscription command, in the order of the topics */
+    static const char* const s_topicNames[CTelemetry::topic_count] = {"imu", "battery", "instant", "resourceMonitor"};
+
+    /** @brief  Index of the first field of the topics, the last item is the number of the fields */
+    static const uint8_t s_topicFields[CTelemetry::topic_count + 1] = {0, 6, 7, 8, CTelemetry::field_count};
+
+    /** @brief  Format of a field: the number of decimals of the fixed-point value in text and the size in the binary frame */
+    struct SFieldFormat
+    {
+        uint8_t decimals;
+        uint8_t size;
+    };
+
+    /** @brief  Format of the fields */
+    static const SFieldFormat s_fieldFormats[CTelemetry::field_count] = {
+        {3, 4}, {3, 4}, {3, 4}, {3, 4}, {3, 4}, {3, 4}, // roll, pitch, heading, vx, vy, vz
+        {0, 2},                                         // voltage
+        {0, 4},                                         // current
+        {2, 2}, {2, 2}, {2, 2}, {0, 4}, {0, 4}          // heap, stack, idle, jitter max, jitter mean
+    };
+
+    /** @brief  Greatest common divisor of the two numbers, the other one when one of them is zero */
+    static uint16_t gcd(uint16_t f_first, uint16_t f_second)
+    {
+        while(f_second != 0)
+        {
+            uint16_t l_rest = f_first % f_second;
+            f_first = f_second;
+            f_second = l_rest;
+        }
+        return f_first;
+    }
+
+    /** \brief  Class constructor
+     *
+     *  It initializes the task without subscriptions, the task runs with the idle period until the first subscription.
+     *
+     *  \param f_period               resolution of the topics' periods
+     *  \param f_serial               serial transmitter of the messages
+     *  \param f_imu                  IMU task
+     *  \param f_totalVoltage         battery voltage task
+     *  \param f_instantConsumption   instant consumption task
+     *  \param f_resourceMonitor      resource monitor task
+     *  \param f_clockSync            clock synchronisation of the time stamps
+     */
+    CTelemetry::CTelemetry(
+            std::chrono::milliseconds f_period,
+            drivers::CSerialTransmitter& f_serial,
+            CImu& f_imu,
+            CTotalVoltage& f_totalVoltage,
+            CInstantConsumption& f_instantConsumption,
+            CResourcemonitor& f_resourceMonitor,
+            CClockSync& f_clockSync)
+        : utils::CTask(std::chrono::milliseconds(idle_period_ms))
+        , m_serial(f_serial)
+        , m_imu(f_imu)
+        , m_totalVoltage(f_totalVoltage)
+        , m_instantConsumption(f_instantConsumption)
+        , m_resourceMonitor(f_resourceMonitor)
+        , m_clockSync(f_clockSync)
+        , m_basePeriod((f_period.count() > 0) ? f_period.count() : 1)
+        , m_topicCycles()
+        , m_topicCounters()
+        , m_stepCycles(0)
+        , m_deadbands()
+        , m_values()
+        , m_sentValues()
+        , m_slowdown(0)
+        , m_slowdownTime(0)
+    {
+    }
+
+    /** @brief  CTelemetry class destructor
+     */
+    CTelemetry::~CTelemetry()
+    {
+    };
+
+    /** \brief  Subscribes to the topic
+     *
+     *  The period is rounded up to a multiple of the resolution, zero unsubscribes. The IMU is sampled with the period of its subscription.
+     *  The period of the task is updated to the new set of subscriptions.
+     *
+     *  @param f_topic            topic
+     *  @param f_period           period in milliseconds
+     *  @param f_deadband         minimum change of a field for sending the topic, zero for sending at each period
+     *  @return                   the applied period in milliseconds
+     */
+    uint32_t CTelemetry::subscribe(ETopic f_topic, uint32_t f_period, uint32_t f_deadband)
+    {
+        uint16_t l_cycles = (uint16_t)((f_period + m_basePeriod - 1) / m_basePeriod);
+        m_topicCycles[f_topic] = l_cycles;
+        m_topicCounters[f_topic] = (l_cycles > 0) ? 1 : 0; // the first check is made at the next cycle
+        m_deadbands[f_topic] = f_deadband;
+
+        // The first message after the subscription is always sent
+        for(uint8_t i = s_topicFields[f_topic]; i < s_topicFields[f_topic + 1]; i++)
+        {
+            m_sentValues[i] = INT32_MIN;
+        }
+
+        if (TOPIC_IMU == f_topic) m_imu.setSamplingPeriod((uint16_t)(l_cycles * m_basePeriod));
+
+        updatePeriod();
+        return l_cycles * m_basePeriod;
+    }
+
+    /** \brief  Applies the period of the task to the subscriptions
+     *
+     *  The task runs with the greatest common divisor of the topics' periods, which is the shortest period, when the others are its 
+     *  multiples. Without subscriptions it runs rarely with the idle period, so the board isn't woken up each resolution.
+     */
+    void CTelemetry::updatePeriod()
+    {
+        uint16_t l_step = 0;
+        for(uint8_t i = 0; i < topic_count; i++)
+        {
+            l_step = gcd(l_step, m_topicCycles[i]);
+        }
+        if(l_step == m_stepCycles) return;
+
+        m_stepCycles = l_step;
+        setNewPeriod((l_step > 0) ? (uint16_t)(l_step * m_basePeriod) : idle_period_ms);
+    }
+
+    /** \brief  Serial callback method to subscribe to a topic
+     *
+     *  The message contains the topic, the period in milliseconds and optionally the deadband ("imu;50", "battery;1000;20"), the zero 
+     *  period unsubscribes. The response is the topic with the applied period and deadband.
+     *
+     *  @param a                   input received string
+     *  @param b                   output reponse message
+     */
+    void CTelemetry::serialCallbackSUBcommand(char const * a, char * b)
+    {
+        utils::CTextParser l_parser(a);
+        const char* l_name;
+        uint32_t l_length;
+        uint32_t l_period;
+        uint32_t l_deadband = 0;
+
+        if(!l_parser.nextField(l_name, l_length) || !l_parser.next(l_period, 0, max_topic_period_ms))
+        {
+            sprintf(b,"syntax error");
+            return;
+        }
+
+        // The deadband is optional, the empty field of the ";;" ending keeps the periodic sending
+        const char* l_field;
+        uint32_t l_fieldLength;
+        utils::CTextParser l_optional(l_parser);
+        if(l_parser.nextField(l_field, l_fieldLength) && (l_fieldLength > 0) && !l_optional.next(l_deadband))
+        {
+            sprintf(b,"syntax error");
+            return;
+        }
+
+        if(uint8_globalsV_value_of_kl != 15 && uint8_globalsV_value_of_kl != 30)
+        {
+            sprintf(b,"kl 15/30 is required!!");
+            return;
+        }
+
+        for(uint8_t i = 0; i < topic_count; i++)
+        {
+            if((strlen(s_topicNames[i]) == l_length) && (strncmp(s_topicNames[i], l_name, l_length) == 0))
+            {
+                uint32_t l_applied = subscribe((ETopic)i, l_period, l_deadband);
+                utils::CTextFormatter l_text(b, _48_chars);
+                l_text.append(s_topicNames[i]).appendChar(';').appendUnsigned(l_applied).appendChar(';').appendUnsigned(l_deadband);
+                return;
+            }
+        }
+        sprintf(b,"syntax error");
+    }
+
+    /** \brief  Serial callback method to report the bandwidth usage of the serial link
+     *
+     *  The response contains the load of the link in percent, the number of the rejected telemetry characters, the slowdown of the 
+     *  telemetry and the characters per second of the sources (frame identifiers) with non-zero rate: "LOAD;REJECTED;SLOWDOWN;ID:RATE;..."
+     *
+     *  @param a                   input received string
+     *  @param b                   output reponse message
+     */
+    void CTelemetry::serialCallbackBANDWIDTHcommand(char const * a, char * b)
+    {
+        uint8_t l_request = 0;
+        utils::CTextParser l_parser(a);
+        if(!l_parser.nextAs<uint8_t>(l_request, 0, UINT8_MAX))
+        {
+            sprintf(b,"syntax error");
+            return;
+        }
+
+        utils::CTextFormatter l_text(b, _100_chars);
+        l_text.appendFixed(m_serial.getLoad(), 2).appendChar(';').appendUnsigned(m_serial.getRejected()).appendChar(';').appendUnsigned(m_slowdown);
+        for(uint8_t i = 0; i < drivers::CSerialTransmitter::id_count; i++)
+        {
+            uint32_t l_rate = m_serial.getRate(i);
+            if(l_rate > 0) l_text.appendChar(';').appendUnsigned(i).appendChar(':').appendUnsigned(l_rate);
+        }
+    }
+
+    /** \brief  Adapts the periods to the load of the serial link
+     *
+     *  The slowdown is changed at most once per second: it's increased while the link is congested and decreased, when the load 
+     *  fell below the half of the congestion level.
+     *
+     *  @param f_time             current time in milliseconds
+     */
+    void CTelemetry::updateSlowdown(uint32_t f_time)
+    {
+        if(f_time - m_slowdownTime < slowdown_interval_ms) return;
+
+        if(m_serial.isCongested())
+        {
+            if(m_slowdown < max_slowdown)
+            {
+                m_slowdown++;
+                m_slowdownTime = f_time;
+            }
+        }
+        else if((m_slowdown > 0) && (m_serial.getLoad() < drivers::CSerialTransmitter::congestion_load / 2))
+        {
+            m_slowdown--;
+            m_slowdownTime = f_time;
+        }
+    }
+
+    /** \brief  Reads the latest values of the topic into the fields
+     *
+     *  @param f_topic            topic
+     */
+    void CTelemetry::readTopic(ETopic f_topic)
+    {
+        int32_t* l_values = &m_values[s_topicFields[f_topic]];
+        switch(f_topic)
+        {
+            case TOPIC_IMU:
+            {
+                const SImuSample& l_sample = m_imu.getSample();
+                l_values[0] = l_sample.roll;
+                l_values[1] = l_sample.pitch;
+                l_values[2] = l_sample.heading;
+                l_values[3] = l_sample.velocityX;
+                l_values[4] = l_sample.velocityY;
+                l_values[5] = l_sample.velocityZ;
+                break;
+            }
+            case TOPIC_BATTERY:
+                l_values[0] = m_totalVoltage.getVoltage();
+                break;
+            case TOPIC_INSTANT:
+                l_values[0] = (int32_t)m_instantConsumption.getCurrent();
+                break;
+            case TOPIC_RESOURCE:
+            {
+                SResourceUsage l_usage;
+                m_resourceMonitor.getUsage(l_usage);
+                l_values[0] = l_usage.heap;
+                l_values[1] = l_usage.stack;
+                l_values[2] = l_usage.idle;
+                l_values[3] = (int32_t)l_usage.jitterMax;
+                l_values[4] = (int32_t)l_usage.jitterMean;
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    /** \brief  Check the topic moved out of its deadband since the last sending
+     *
+     *  @param f_topic            topic
+     *  @return                   true, when the topic has to be sent
+     */
+    bool CTelemetry::isChanged(ETopic f_topic)
+    {
+        if(0 == m_deadbands[f_topic]) return true;
+
+        for(uint8_t i = s_topicFields[f_topic]; i < s_topicFields[f_topic + 1]; i++)
+        {
+            if(INT32_MIN == m_sentValues[i]) return true;
+            int64_t l_change = (int64_t)m_values[i] - m_sentValues[i];
+            if((l_change >= (int64_t)m_deadbands[f_topic]) || (-l_change >= (int64_t)m_deadbands[f_topic])) return true;
+        }
+        return false;
+    }
+
+    /** \brief  Periodically checks the subscribed topics and sends the changed ones in one message
+     *
+     *  No message is sent while the kl is 0, like the producers are disabled, the subscriptions are kept.
+     */
+    void CTelemetry::_run()
+    {
+        if(0 == uint8_globalsV_value_of_kl) return;
+
+        updateSlowdown((uint32_t)Kernel::Clock::now().time_since_epoch().count());
+        uint32_t l_time;
+        bool l_hostTime = m_clockSync.toHost(us_ticker_read(), l_time);
+
+        uint8_t l_mask = 0;
+        for(uint8_t i = 0; i < topic_count; i++)
+        {
+            if(m_topicCycles[i] == 0) continue;
+            // The counters left over from a shorter step are checked at the next run
+            if(m_topicCounters[i] > m_stepCycles)
+            {
+                m_topicCounters[i] -= m_stepCycles;
+                continue;
+            }
+            m_topicCounters[i] = (uint16_t)(m_topicCycles[i] << m_slowdown);
+
+            readTopic((ETopic)i);
+            if(isChanged((ETopic)i))
+            {
+                l_mask |= (1 << i);
+                memcpy(&m_sentValues[s_topicFields[i]], &m_values[s_topicFields[i]], (s_topicFields[i + 1] - s_topicFields[i]) * sizeof(int32_t));
+            }
+        }
+
+        if(0 == l_mask) return;
+        if(l_hostTime) l_mask |= host_time_flag;
+
+        if(m_serial.isBinaryMode()) sendBinary(l_time, l_mask);
+        else sendText(l_time, l_mask);
+    }
+
+    /** \brief  Sends the topics of the mask in one text message
+     *
+     *  @param f_time             time of the message in microseconds
+     *  @param f_mask             topics of the message
+     */
+    void CTelemetry::sendText(uint32_t f_time, uint8_t f_mask)
+    {
+        char buffer[_200_chars];
+        utils::CTextFormatter l_text(buffer, sizeof(buffer));
+        l_text.append("@telemetry:").appendUnsigned(f_time).appendChar(';').appendUnsigned(f_mask);
+
+        for(uint8_t l_topic = 0; l_topic < topic_count; l_topic++)
+        {
+            if(!(f_mask & (1 << l_topic))) continue;
+            for(uint8_t i = s_topicFields[l_topic]; i < s_topicFields[l_topic + 1]; i++)
+            {
+                l_text.appendChar(';').appendFixed(m_values[i], s_fieldFormats[i].decimals);
+            }
+        }
+        l_text.append(";;\r\n");
+        m_serial.write(buffer, l_text.length(), drivers::CSerialTransmitter::ID_TELEMETRY, drivers::CSerialTransmitter::PRIORITY_TELEMETRY);
+    }
+
+    /** \brief  Sends the topics of the mask in one binary frame
+     *
+     *  @param f_time             time of the message in microseconds
+     *  @param f_mask             topics of the message
+     */
+    void CTelemetry::sendBinary(uint32_t f_time, uint8_t f_mask)
+    {
+        uint8_t l_payload[telemetry_payload_size];
+        uint8_t* l_it = utils::CBinaryFrame::putU32(l_payload, f_time);
+        *l_it++ = f_mask;
+
+        for(uint8_t l_topic = 0; l_topic < topic_count; l_topic++)
+        {
+            if(!(f_mask & (1 << l_topic))) continue;
+            for(uint8_t i = s_topicFields[l_topic]; i < s_topicFields[l_topic + 1]; i++)
+            {
+                if(2 == s_fieldFormats[i].size) l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)m_values[i]);
+                else l_it = utils::CBinaryFrame::putU32(l_it, (uint32_t)m_values[i]);
+            }
+        }
+        m_serial.writeFrame(drivers::CSerialTransmitter::ID_TELEMETRY, l_payload, l_it - l_payload, drivers::CSerialTransmitter::PRIORITY_TELEMETRY);
+    }
+
+}; // namespace periodics
\ No newline at end of file
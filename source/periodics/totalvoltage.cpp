@@ -50,7 +50,7 @@ namespace periodics{
     CTotalVoltage::CTotalVoltage(
             std::chrono::milliseconds f_period, 
             mbed::AnalogIn f_pin, 
-            UnbufferedSerial& f_serial) 
+            drivers::CSerialTransmitter& f_serial) 
         : utils::CTask(f_period)
         , m_pin(f_pin)
         , m_serial(f_serial)
@@ -75,9 +75,9 @@ namespace periodics{
      */
     void CTotalVoltage::serialCallbackTOTALVcommand(char const * a, char * b) {
         uint8_t l_isActivate=0;
-        uint8_t l_res = sscanf(a,"%hhu",&l_isActivate);
+        utils::CTextParser l_parser(a);
 
-        if(1 == l_res){
+        if(l_parser.nextAs<uint8_t>(l_isActivate, 0, UINT8_MAX)){
             if(uint8_globalsV_value_of_kl == 15 || uint8_globalsV_value_of_kl == 30)
             {
                 m_isActive=(l_isActivate>=1);
@@ -92,6 +92,13 @@ namespace periodics{
         }
     }
 
+    /** \brief  Latest battery voltage in mV, it's measured by the safety measure, zero when no battery is connected
+     */
+    uint16_t CTotalVoltage::getVoltage()
+    {
+        return uint16_globalsV_battery_totalVoltage;
+    }
+
     void CTotalVoltage::void_TotalSafetyMeasure()
     {
         if(m_adcCounter < two_seconds_in_task_calls) {m_adcCounter++; return;}
@@ -124,10 +131,20 @@ namespace periodics{
     {
         if(!m_isActive) return;
 
+        if(m_serial.isBinaryMode())
+        {
+            // Battery voltage in mV
+            uint8_t l_payload[2];
+            utils::CBinaryFrame::putU16(l_payload, uint16_globalsV_battery_totalVoltage);
+            m_serial.writeFrame(drivers::CSerialTransmitter::ID_BATTERY, l_payload, sizeof(l_payload), drivers::CSerialTransmitter::PRIORITY_TELEMETRY);
+            return;
+        }
+
         char buffer[_18_chars];
 
-        snprintf(buffer, sizeof(buffer), "@battery:%d;;\r\n", uint16_globalsV_battery_totalVoltage);
-        m_serial.write(buffer,strlen(buffer));
+        utils::CTextFormatter l_text(buffer, sizeof(buffer));
+        l_text.append("@battery:").appendUnsigned(uint16_globalsV_battery_totalVoltage).append(";;\r\n");
+        m_serial.write(buffer, l_text.length(), drivers::CSerialTransmitter::ID_BATTERY, drivers::CSerialTransmitter::PRIORITY_TELEMETRY);
     }
 
 }; // namespace periodics
\ No newline at end of file
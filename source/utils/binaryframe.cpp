@@ -0,0 +1,136 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+
+#include <utils/binaryframe.hpp>
+#include <string.h>
+
+namespace utils{
+
+    /** @brief  Encodes a frame
+     *
+     *  The identifier, the payload and the CRC are encoded with COBS and the zero delimiter is appended.
+     *
+     *  @param f_id          identifier of the command
+     *  @param f_payload     payload
+     *  @param f_length      length of the payload, at most binary_payload_max
+     *  @param f_frame       destination, at least binary_frame_max bytes
+     *  @return    Length of the encoded frame with the delimiter, zero if the payload is too long
+     */
+    uint32_t CBinaryFrame::encode(uint8_t f_id, const uint8_t* f_payload, uint32_t f_length, uint8_t* f_frame)
+    {
+        if (f_length > binary_payload_max) return 0;
+
+        uint8_t l_raw[binary_payload_max + 3];
+        l_raw[0] = f_id;
+        memcpy(&l_raw[1], f_payload, f_length);
+        putU16(&l_raw[f_length + 1], crc16(l_raw, f_length + 1));
+
+        uint32_t l_out = 1;
+        uint32_t l_codeIdx = 0;
+        uint8_t l_code = 1;
+        for (uint32_t i = 0; i < f_length + 3; i++)
+        {
+            if (l_raw[i] == 0)
+            {
+                f_frame[l_codeIdx] = l_code;
+                l_codeIdx = l_out++;
+                l_code = 1;
+            }
+            else
+            {
+                f_frame[l_out++] = l_raw[i];
+                if (++l_code == 0xFF) // Block of 254 non-zero bytes
+                {
+                    f_frame[l_codeIdx] = l_code;
+                    l_codeIdx = l_out++;
+                    l_code = 1;
+                }
+            }
+        }
+        f_frame[l_codeIdx] = l_code;
+        f_frame[l_out++] = 0;
+        return l_out;
+    }
+
+    /** @brief  Decodes a frame
+     *
+     *  The COBS encoded frame is decoded in place and the CRC is checked. The frame starts with the identifier followed by the payload.
+     *
+     *  @param f_frame       encoded frame without the delimiter
+     *  @param f_length      length of the encoded frame
+     *  @return    Length of the identifier and the payload, -1 if the frame is corrupted
+     */
+    int32_t CBinaryFrame::decode(uint8_t* f_frame, uint32_t f_length)
+    {
+        uint32_t l_in = 0;
+        uint32_t l_out = 0;
+
+        while (l_in < f_length)
+        {
+            uint8_t l_code = f_frame[l_in++];
+            if (l_code == 0) return -1;
+            for (uint8_t i = 1; i < l_code; i++)
+            {
+                if ((l_in >= f_length) || (f_frame[l_in] == 0)) return -1;
+                f_frame[l_out++] = f_frame[l_in++];
+            }
+            if ((l_code < 0xFF) && (l_in < f_length)) f_frame[l_out++] = 0;
+        }
+
+        if (l_out < 3) return -1;
+        l_out -= 2;
+        uint16_t l_crc = f_frame[l_out] | (f_frame[l_out + 1] << 8);
+        return (crc16(f_frame, l_out) == l_crc) ? (int32_t)l_out : -1;
+    }
+
+    /** @brief  CRC-16/CCITT-FALSE
+     *
+     *  Polynomial 0x1021, initial value 0xFFFF, it's computed byte by byte without table.
+     *
+     *  @param f_data        data
+     *  @param f_length      length of the data
+     *  @param f_crc         initial value or the CRC of the previous data
+     *  @return    CRC of the data
+     */
+    uint16_t CBinaryFrame::crc16(const uint8_t* f_data, uint32_t f_length, uint16_t f_crc)
+    {
+        for (uint32_t i = 0; i < f_length; i++)
+        {
+            f_crc = (uint16_t)((f_crc >> 8) | (f_crc << 8));
+            f_crc ^= f_data[i];
+            f_crc ^= (f_crc & 0xFF) >> 4;
+            f_crc ^= (uint16_t)(f_crc << 12);
+            f_crc ^= (uint16_t)((f_crc & 0xFF) << 5);
+        }
+        return f_crc;
+    }
+
+}; // namespace utils
\ No newline at end of file
@@ -42,9 +42,19 @@ namespace utils{
      */
     CTask::CTask(std::chrono::milliseconds f_period) 
         : m_period(f_period)
-        , m_ticks(std::chrono::milliseconds(0))
         , m_triggered(false) 
+        , m_manager(NULL)
+        , m_deadline(0)
+        , m_heapIndex(0)
+        , m_notifyTime(0)
+        , m_latency(0)
+        , m_consecutiveOverruns(0)
+        , m_overrunPolicy(SKIP)
+        , m_hardDeadline(0)
+        , m_stalled(false)
+        , m_id(0)
     {
+        resetStats();
     }
 
     /** \brief  CTask class destructor
@@ -54,27 +64,47 @@ namespace utils{
     {
     }
 
+    /** \brief  Set new period
+     *
+     *  It changes the period of the task and restarts the counting from the current moment.
+     *
+     *  @param f_period      new period in milliseconds
+     */
     void CTask::setNewPeriod(uint16_t f_period)
     {
         m_period = std::chrono::milliseconds(f_period);
-        m_ticks = std::chrono::milliseconds(0);
+        if (m_manager != NULL)
+        {
+            m_manager->reschedule(*this);
+        }
     }
 
-    /** @brief  Timer callback */
-    void CTask::timerCallback()
+    /** \brief  Requests a run of the task
+     *
+     *  The task will be applied by the task manager at its next pass, the manager is woken up from idle. 
+     *  It can be applied from interrupt context, when new data arrived for the task.
+     */
+    void CTask::notify()
     {
-        m_ticks += std::chrono::milliseconds(1);
-        if (m_ticks >= m_period)
+        if (m_manager != NULL)
         {
-            m_ticks = std::chrono::milliseconds(0);
-            m_triggered = true;
+            m_manager->notify(*this);
         }
     }
 
+    /** @brief  Timer callback
+     *
+     *  It is applied by the task manager, when the deadline of the task has been reached.
+     */
+    void CTask::timerCallback()
+    {
+        m_triggered = true;
+    }
+
     /** \brief  Run method
      *
      *  It applies the '_run' method, which implements the task's functionality. It has to override in the derived class.  
-     *  
+     *  The run time is measured with the cycle counter.
      *  
      */
     void CTask::run()
@@ -82,8 +112,104 @@ namespace utils{
         if (m_triggered)
         {
             m_triggered = false;
+            uint32_t l_start = CCycleCounter::read();
             _run();
+            recordRun(CCycleCounter::read() - l_start);
         }
-    }// namespace CTask
+    }
+
+    /** @brief  Execution statistics */
+    const STaskStats& CTask::getStats()
+    {
+        return m_stats;
+    }
+
+    /** @brief  Clears the execution statistics */
+    void CTask::resetStats()
+    {
+        m_stats.runCount = 0;
+        m_stats.runMin = UINT32_MAX;
+        m_stats.runMax = 0;
+        m_stats.runSum = 0;
+        m_stats.latencyMax = 0;
+        m_stats.latencySum = 0;
+        m_stats.overruns = 0;
+        m_stats.consecutiveOverrunsMax = 0;
+        m_stats.missed = 0;
+        m_stats.hardMisses = 0;
+    }
+
+    /** \brief  Set the handling of the missed activations
+     *
+     *  @param f_policy      skip, catch up or alert
+     */
+    void CTask::setOverrunPolicy(EOverrunPolicy f_policy)
+    {
+        m_overrunPolicy = f_policy;
+    }
+
+    /** \brief  Set the hard deadline
+     *
+     *  The run of the task has to be finished in the given time after its activation, otherwise the task manager 
+     *  counts a hard miss and applies its deadline callback.
+     *
+     *  @param f_deadline    deadline relative to the activation, zero disables it
+     */
+    void CTask::setHardDeadline(std::chrono::milliseconds f_deadline)
+    {
+        m_hardDeadline = (uint32_t)f_deadline.count();
+    }
+
+    /** @brief  Index of the task in the task manager's list */
+    uint8_t CTask::getId()
+    {
+        return m_id;
+    }
+
+    /** \brief  Records the delay of the start from the deadline
+     *
+     *  @param f_latency     start latency in microseconds
+     */
+    void CTask::recordLatency(uint32_t f_latency)
+    {
+        m_latency = f_latency;
+        if (f_latency > m_stats.latencyMax) m_stats.latencyMax = f_latency;
+        m_stats.latencySum += f_latency;
+    }
+
+    /** \brief  Records the run time
+     *
+     *  The run is an overrun, when it finished after the next deadline of the task. The tasks without period have no overruns.
+     *
+     *  @param f_cycles      run time in cycle counter units
+     */
+    void CTask::recordRun(uint32_t f_cycles)
+    {
+        m_stats.runCount++;
+        if (f_cycles < m_stats.runMin) m_stats.runMin = f_cycles;
+        if (f_cycles > m_stats.runMax) m_stats.runMax = f_cycles;
+        m_stats.runSum += f_cycles;
+
+        if ((m_period.count() > 0) && (m_latency + CCycleCounter::toMicroseconds(f_cycles) >= (uint32_t)m_period.count() * 1000))
+        {
+            m_stats.overruns++;
+            m_consecutiveOverruns++;
+            if (m_consecutiveOverruns > m_stats.consecutiveOverrunsMax) m_stats.consecutiveOverrunsMax = m_consecutiveOverruns;
+        }
+        else
+        {
+            m_consecutiveOverruns = 0;
+        }
+        m_latency = 0;
+    }
+
+    /** \brief  Records the skipped activations
+     *
+     *  @param f_missed      number of activations, which were dropped
+     */
+    void CTask::recordMissed(uint32_t f_missed)
+    {
+        m_stats.missed += f_missed;
+    }
 
 }; // namespace utils
\ No newline at end of file
@@ -31,11 +31,19 @@
 
 #include <utils/taskmanager.hpp>
 
+#define wakeup_flag     0x01
+#define window_us       1000000
+#define max_percent_int 10000 // 100.00%
+#define event_task      0xFF  // heap index of the tasks without period
+#define max_task_count  32    // the notifications are kept in a 32-bit mask, one bit for each task
+
 namespace utils{
     /******************************************************************************/
     /** \brief  CTaskManager class constructor
      *
-     *  Constructor method
+     *  Constructor method. It builds the heap of the periodic tasks, each task has the first deadline after one period. 
+     *  The tasks with zero period are kept out of the heap, they are applied only after a notification. 
+     *  The index of the task is its bit in the mask of the notifications, so at most 32 tasks are supported.
      *
      *  @param f_taskList      list of tasks
      *  @param f_taskCount     number of tasks
@@ -47,9 +55,37 @@ namespace utils{
             std::chrono::milliseconds f_baseFreq
         )
         : m_taskList(f_taskList)
-        , m_taskCount(f_taskCount)
+        , m_taskCount((f_taskCount > max_task_count) ? max_task_count : f_taskCount) // the release builds drop the extra tasks
+        , m_heap(new utils::CTask*[m_taskCount])
+        , m_heapCount(0)
+        , m_notified(0)
+        , m_baseTick((uint32_t)f_baseFreq.count())
+        , m_windowStart(0)
+        , m_idleTime(0)
+        , m_jitterMax(0)
+        , m_jitterSum(0)
+        , m_jitterCount(0)
+        , m_idlePercent(0)
+        , m_lastJitterMax(0)
+        , m_lastJitterMean(0)
     {
-        m_ticker.attach(mbed::callback(this,&CTaskManager::timerCallback), f_baseFreq);
+        MBED_ASSERT(f_taskCount <= max_task_count);
+        for(uint8_t i = 0; i < m_taskCount; i++)
+        {
+            utils::CTask* l_task = m_taskList[i];
+            l_task->m_manager = this;
+            l_task->m_id = i;
+            if(l_task->m_period.count() == 0)
+            {
+                l_task->m_heapIndex = event_task;
+                continue;
+            }
+            l_task->m_deadline = getPeriod(*l_task);
+            place(l_task, m_heapCount);
+            siftUp(m_heapCount++);
+        }
+        CCycleCounter::init();
+        m_timer.start();
     }
 
     /** \brief  CTaskManager class destructor
@@ -57,25 +93,297 @@ namespace utils{
      */
     CTaskManager::~CTaskManager() 
     {
-        m_ticker.detach();
+        m_timer.stop();
+        delete[] m_heap;
     }
     
-    /** @brief  The main callback method aims to apply the subtasks' run method. */
+    /** @brief  The main callback method aims to apply the subtasks' run method. 
+     *
+     *  Only the tasks from the top of the heap are visited, which deadline has been reached. The next deadline of the task is computed
+     *  before applying it, so the task can change its own period. If the task was delayed over more periods, the missed activations are 
+     *  skipped and counted, except for the tasks with catch up policy, which are applied again as soon as possible for each activation. 
+     *  A hard deadline miss is reported only for the first late run, until the task meets its hard deadline again. 
+     *  The notified tasks are applied after the periodic ones. Then the manager sleeps until the next deadline or the next notification.
+     */
     void CTaskManager::mainCallback()
     {
-        for(uint8_t i = 0; i < m_taskCount; i++)
+        uint32_t l_now = getNow();
+
+        while((m_heapCount > 0) && isDue(m_heap[0]->m_deadline, l_now))
+        {
+            utils::CTask* l_task = m_heap[0];
+            uint32_t l_period = getPeriod(*l_task);
+            uint32_t l_activation = l_task->m_deadline;
+            uint32_t l_missed = 0;
+
+            int32_t l_latency = (int32_t)((uint32_t)m_timer.elapsed_time().count() - l_activation * 1000);
+            l_task->recordLatency((l_latency > 0) ? (uint32_t)l_latency : 0);
+
+            l_task->m_deadline += l_period;
+            if(isDue(l_task->m_deadline, l_now) && (l_task->m_overrunPolicy != utils::CTask::CATCH_UP))
+            {
+                l_missed = (l_now - l_task->m_deadline) / l_period + 1;
+                l_task->m_deadline += l_missed * l_period;
+            }
+            siftDown(0);
+
+            l_task->timerCallback();
+            l_task->run();
+
+            if(l_missed > 0)
+            {
+                l_task->recordMissed(l_missed);
+                if((l_task->m_overrunPolicy == utils::CTask::ALERT) && m_deadlineCallback)
+                {
+                    m_deadlineCallback(*l_task, false);
+                }
+            }
+
+            checkHardDeadline(*l_task, l_activation * 1000);
+        }
+
+        runNotified();
+
+        if(m_heapCount > 0)
         {
-            m_taskList[i]->run();
+            idle(m_heap[0]->m_deadline);
+        }
+        else
+        {
+            m_wakeFlags.wait_any(wakeup_flag);
         }
     }
 
-    /** @brief  Timer callback method applies the subtasks' callback function. */
-    void CTaskManager::timerCallback()
+    /** @brief  Applies the notified tasks.
+     *
+     *  The notifications are taken over atomically, the notifications arriving during the runs are applied at the next pass. 
+     *  The start latency and the hard deadline of a notified task are measured from its first notification.
+     */
+    void CTaskManager::runNotified()
     {
-        for(uint8_t i = 0; i < m_taskCount; i++)
+        uint32_t l_notified = core_util_atomic_exchange_u32(&m_notified, 0);
+
+        for(uint8_t i = 0; (i < m_taskCount) && (l_notified != 0); i++)
+        {
+            uint32_t l_bit = 1UL << i;
+            if(l_notified & l_bit)
+            {
+                l_notified &= ~l_bit;
+                utils::CTask* l_task = m_taskList[i];
+                l_task->recordLatency((uint32_t)m_timer.elapsed_time().count() - l_task->m_notifyTime);
+                l_task->timerCallback();
+                l_task->run();
+                checkHardDeadline(*l_task, l_task->m_notifyTime);
+            }
+        }
+    }
+
+    /** @brief  Checks the hard deadline of the task after its run.
+     *
+     *  A stall is reported once, the next late runs (e.g. the runs catching up the missed activations) aren't counted again, 
+     *  until the task meets its hard deadline.
+     *
+     *  @param f_task          the applied task
+     *  @param f_activation    time of the activation (deadline or first notification) in microseconds
+     */
+    void CTaskManager::checkHardDeadline(utils::CTask& f_task, uint32_t f_activation)
+    {
+        if(f_task.m_hardDeadline == 0) return;
+
+        bool l_late = (int32_t)((uint32_t)m_timer.elapsed_time().count() - f_activation) > (int32_t)(f_task.m_hardDeadline * 1000);
+        if(l_late && !f_task.m_stalled)
+        {
+            f_task.m_stats.hardMisses++;
+            if(m_deadlineCallback)
+            {
+                m_deadlineCallback(f_task, true);
+            }
+        }
+        f_task.m_stalled = l_late;
+    }
+
+    /** \brief  Attach the callback applied on missed deadlines
+     *
+     *  @param f_callback      callback applied with the task and true for hard deadline miss, false for missed activations
+     */
+    void CTaskManager::attachDeadlineCallback(FDeadlineCallback f_callback)
+    {
+        m_deadlineCallback = f_callback;
+    }
+
+    /** @brief  Wakes up the manager from the idle state, it can be applied from interrupt context. */
+    void CTaskManager::wakeUp()
+    {
+        m_wakeFlags.set(wakeup_flag);
+    }
+
+    /** @brief  Marks the task for running and wakes up the manager, it can be applied from interrupt context.
+     *
+     *  The time of the first notification is saved for measuring the start latency, the repeated notifications before the run 
+     *  are merged.
+     *
+     *  @param f_task          notified task
+     */
+    void CTaskManager::notify(utils::CTask& f_task)
+    {
+        uint32_t l_bit = 1UL << f_task.m_id;
+        if(!(core_util_atomic_fetch_or_u32(&m_notified, l_bit) & l_bit))
+        {
+            f_task.m_notifyTime = (uint32_t)m_timer.elapsed_time().count();
+        }
+        m_wakeFlags.set(wakeup_flag);
+    }
+
+    /** @brief  Sleeps until the deadline or until the manager is woken up.
+     *
+     *  The main thread waits on the event flags, so the RTOS idle thread puts the MCU to sleep through the sleep manager. 
+     *  The time spent in waiting is accumulated as idle time and the delay of the timed wake-ups from the deadline as jitter.
+     *
+     *  @param f_deadline      the earliest deadline in milliseconds
+     */
+    void CTaskManager::idle(uint32_t f_deadline)
+    {
+        uint64_t l_start = m_timer.elapsed_time().count();
+        // Remaining time in microseconds, the sleep is rounded up to whole milliseconds
+        int32_t l_remaining = (int32_t)(f_deadline * 1000 - (uint32_t)l_start);
+
+        if(l_remaining > 0)
+        {
+            uint32_t l_flags = m_wakeFlags.wait_any_for(wakeup_flag, Kernel::Clock::duration_u32((l_remaining + 999) / 1000));
+            uint64_t l_end = m_timer.elapsed_time().count();
+
+            m_idleTime += l_end - l_start;
+
+            // Timed wake-up, the flag wasn't set
+            if((l_flags & osFlagsError) || !(l_flags & wakeup_flag))
+            {
+                int32_t l_delay = (int32_t)((uint32_t)l_end - f_deadline * 1000);
+                if(l_delay < 0) l_delay = 0;
+                if((uint32_t)l_delay > m_jitterMax) m_jitterMax = l_delay;
+                m_jitterSum += l_delay;
+                m_jitterCount++;
+            }
+            l_start = l_end;
+        }
+
+        if(l_start - m_windowStart >= window_us)
+        {
+            m_idlePercent = (uint16_t)((m_idleTime * max_percent_int) / (l_start - m_windowStart));
+            m_lastJitterMax = m_jitterMax;
+            m_lastJitterMean = (m_jitterCount > 0) ? (m_jitterSum / m_jitterCount) : 0;
+
+            m_windowStart = l_start;
+            m_idleTime = 0;
+            m_jitterMax = 0;
+            m_jitterSum = 0;
+            m_jitterCount = 0;
+        }
+    }
+
+    /** @brief  Idle time in the last window, in hundredths of percent */
+    uint16_t CTaskManager::getIdlePercent()
+    {
+        return m_idlePercent;
+    }
+
+    /** @brief  Maximum wake-up delay in the last window, in microseconds */
+    uint32_t CTaskManager::getWakeupJitterMax()
+    {
+        return m_lastJitterMax;
+    }
+
+    /** @brief  Average wake-up delay in the last window, in microseconds */
+    uint32_t CTaskManager::getWakeupJitterMean()
+    {
+        return m_lastJitterMean;
+    }
+
+    /** @brief  Recomputes the deadline of the task after its period has been changed.
+     *
+     *  The next activation of the task will be after one period from the current moment. The event driven tasks aren't affected.
+     *
+     *  @param f_task          task with the new period
+     */
+    void CTaskManager::reschedule(utils::CTask& f_task)
+    {
+        if(f_task.m_heapIndex == event_task) return;
+        f_task.m_deadline = getNow() + getPeriod(f_task);
+        siftUp(f_task.m_heapIndex);
+        siftDown(f_task.m_heapIndex);
+    }
+
+    /** @brief  Number of tasks */
+    uint8_t CTaskManager::getTaskCount()
+    {
+        return m_taskCount;
+    }
+
+    /** @brief  Task from the list, in the order of the list given to the constructor */
+    utils::CTask* CTaskManager::getTask(uint8_t f_index)
+    {
+        return (f_index < m_taskCount) ? m_taskList[f_index] : NULL;
+    }
+
+    /** @brief  Current time in milliseconds */
+    uint32_t CTaskManager::getNow()
+    {
+        return (uint32_t)(m_timer.elapsed_time().count() / 1000);
+    }
+
+    /** @brief  Check the deadline has been reached. The difference is signed, so the overflow of the time base is handled. */
+    bool CTaskManager::isDue(uint32_t f_deadline, uint32_t f_now)
+    {
+        return (int32_t)(f_now - f_deadline) >= 0;
+    }
+
+    /** @brief  Check the first deadline is before the second one. */
+    bool CTaskManager::isEarlier(uint32_t f_first, uint32_t f_second)
+    {
+        return (int32_t)(f_first - f_second) < 0;
+    }
+
+    /** @brief  Period of the task in milliseconds, it's at least one base tick. */
+    uint32_t CTaskManager::getPeriod(utils::CTask& f_task)
+    {
+        uint32_t l_period = (uint32_t)f_task.m_period.count();
+        return (l_period < m_baseTick) ? m_baseTick : l_period;
+    }
+
+    /** @brief  Place the task on the position of the heap */
+    void CTaskManager::place(utils::CTask* f_task, uint8_t f_index)
+    {
+        m_heap[f_index] = f_task;
+        f_task->m_heapIndex = f_index;
+    }
+
+    /** @brief  Move the task up in the heap, while its deadline is earlier than the parent's deadline. */
+    void CTaskManager::siftUp(uint8_t f_index)
+    {
+        utils::CTask* l_task = m_heap[f_index];
+        while(f_index > 0)
+        {
+            uint8_t l_parent = (f_index - 1) / 2;
+            if(!isEarlier(l_task->m_deadline, m_heap[l_parent]->m_deadline)) break;
+            place(m_heap[l_parent], f_index);
+            f_index = l_parent;
+        }
+        place(l_task, f_index);
+    }
+
+    /** @brief  Move the task down in the heap, while one of the children has an earlier deadline. */
+    void CTaskManager::siftDown(uint8_t f_index)
+    {
+        utils::CTask* l_task = m_heap[f_index];
+        while(true)
         {
-            m_taskList[i]->timerCallback();
+            uint16_t l_child = 2 * f_index + 1;
+            if(l_child >= m_heapCount) break;
+            if((l_child + 1 < m_heapCount) && isEarlier(m_heap[l_child + 1]->m_deadline, m_heap[l_child]->m_deadline)) l_child++;
+            if(!isEarlier(m_heap[l_child]->m_deadline, l_task->m_deadline)) break;
+            place(m_heap[l_child], f_index);
+            f_index = l_child;
         }
+        place(l_task, f_index);
     }
 
 }; // namespace utils::task
\ No newline at end of file
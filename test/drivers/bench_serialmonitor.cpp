@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+#include <algorithm>
+#include <vector>
+#include <drivers/serialmonitor.hpp>
+
+#define message_count 100000
+
+/**
+ * Latency from the receive interrupt to the subscriber callback: the characters of a command are received by one interrupt 
+ * (like the idle line interrupt of the DMA reception), the serial monitor is notified and applied by the task manager, which 
+ * dispatches the command. The time is measured with the host clock, so it shows the cost of the software path (notification, 
+ * parsing, key lookup), not the wake-up time of the target.
+ */
+
+typedef std::chrono::steady_clock::time_point CTime;
+
+/** @brief  Time of the last subscriber callback */
+static CTime s_callbackTime;
+/** @brief  Number of the subscriber callbacks */
+static uint32_t s_callbacks = 0;
+
+static void speedCallback(char const * /* a */, char * b)
+{
+    s_callbackTime = std::chrono::steady_clock::now();
+    s_callbacks++;
+    sprintf(b, "0");
+}
+
+static void steerCallback(char const * /* a */, char * b)
+{
+    sprintf(b, "0");
+}
+
+/** @brief  Latencies of the message in nanoseconds */
+static std::vector<uint32_t> measure(UnbufferedSerial& f_port, utils::CTaskManager& f_manager, const char* f_message)
+{
+    std::vector<uint32_t> l_latencies;
+    l_latencies.reserve(message_count);
+    uint32_t l_length = strlen(f_message);
+
+    for(uint32_t i = 0; i < message_count; i++)
+    {
+        CTime l_rxTime = std::chrono::steady_clock::now();
+        f_port.receive(f_message, l_length);
+        f_manager.mainCallback();
+        l_latencies.push_back((uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(s_callbackTime - l_rxTime).count());
+        f_port.transmit(); // the response is sent, so the queue doesn't fill up
+    }
+    std::sort(l_latencies.begin(), l_latencies.end());
+    return l_latencies;
+}
+
+/** @brief  Prints the distribution of the latencies */
+static void report(const char* f_name, const std::vector<uint32_t>& f_latencies)
+{
+    uint64_t l_sum = 0;
+    for(uint32_t l_latency : f_latencies) l_sum += l_latency;
+    printf("%-34s min %6u ns  mean %6u ns  p99 %6u ns  max %8u ns\n", f_name, f_latencies.front(), 
+        (uint32_t)(l_sum / f_latencies.size()), f_latencies[f_latencies.size() * 99 / 100], f_latencies.back());
+}
+
+int main()
+{
+    static const drivers::CSerialMonitor::SSubscriber s_subscribers[] = {
+        {"speed", mbed::callback(speedCallback), drivers::CSerialTransmitter::ID_TEXT},
+        {"steer", mbed::callback(steerCallback), drivers::CSerialTransmitter::ID_TEXT},
+    };
+    UnbufferedSerial l_port(USBTX, USBRX, 115200);
+    drivers::CSerialTransmitter l_transmitter(l_port, 115200);
+    drivers::CSerialMonitor l_monitor(l_port, l_transmitter, s_subscribers, 2, 115200);
+    utils::CTask* l_tasks[] = {&l_monitor};
+    utils::CTaskManager l_manager(l_tasks, 1, std::chrono::milliseconds(1));
+
+    report("#speed:12;;", measure(l_port, l_manager, "#speed:12;;\r\n"));
+    report("#speed/7:12;; (stamped)", measure(l_port, l_manager, "#speed/7:12;;\r\n"));
+    report("#steer:3;;|speed:12;; (coalesced)", measure(l_port, l_manager, "#steer:3;;|speed:12;;\r\n"));
+
+    // Each message has to reach the subscriber
+    if(s_callbacks != 3 * message_count)
+    {
+        printf("%u of %u messages were dispatched\n", s_callbacks, 3 * message_count);
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,245 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+#include <string.h>
+#include <unittest.hpp>
+#include <drivers/bno055shadow.hpp>
+
+/**
+ * Simulated sensor: the two register pages and the page register, the bus accesses are counted. The same sequences of 
+ * driver calls are applied directly and through the shadow, the registers of the sensor have to end in the same state.
+ */
+namespace sensor
+{
+    static u8 s_registers[bno055_shadow_pages][bno055_shadow_registers];
+    static u8 s_page = BNO055_PAGE_ZERO;
+    static uint32_t s_reads = 0;
+    static uint32_t s_writes = 0;
+    static bool s_failWrite = false;
+
+    static s8 write(u8 /* dev_addr */, u8 reg_addr, u8* reg_data, u8 cnt)
+    {
+        s_writes++;
+        if(s_failWrite)
+        {
+            s_failWrite = false;
+            return BNO055_ERROR;
+        }
+        for(u8 i = 0; i < cnt; i++)
+        {
+            if(reg_addr + i == BNO055_PAGE_ID_ADDR) s_page = reg_data[i] & BNO055_PAGE_ONE;
+            else s_registers[s_page][reg_addr + i] = reg_data[i];
+        }
+        return BNO055_SUCCESS;
+    }
+
+    static s8 read(u8 /* dev_addr */, u8 reg_addr, u8* reg_data, u8 cnt)
+    {
+        s_reads++;
+        for(u8 i = 0; i < cnt; i++)
+        {
+            reg_data[i] = (reg_addr + i == BNO055_PAGE_ID_ADDR) ? s_page : s_registers[s_page][reg_addr + i];
+        }
+        return BNO055_SUCCESS;
+    }
+
+    static void delay(u32 /* msec */)
+    {
+    }
+
+    /** @brief  Power-on state, the Euler angles in radians, so the startup has to change the unit */
+    static void reset()
+    {
+        memset(s_registers, 0, sizeof(s_registers));
+        s_registers[BNO055_PAGE_ZERO][BNO055_CHIP_ID_ADDR] = 0xA0;
+        s_registers[BNO055_PAGE_ZERO][BNO055_UNIT_SEL_ADDR] = 0x84;
+        s_page = BNO055_PAGE_ZERO;
+        s_reads = 0;
+        s_writes = 0;
+        s_failWrite = false;
+    }
+
+    static uint32_t accesses()
+    {
+        return s_reads + s_writes;
+    }
+}; // namespace sensor
+
+static struct bno055_t s_bno055;
+
+/** @brief  Initializes the driver on the simulated sensor, directly or through the shadow */
+static void init(bool f_shadow)
+{
+    sensor::reset();
+    s_bno055.dev_addr = BNO055_I2C_ADDR2;
+    s_bno055.delay_msec = sensor::delay;
+    if(f_shadow)
+    {
+        drivers::CBno055Shadow::attach(sensor::write, sensor::read);
+        drivers::CBno055Shadow::resetStats();
+        s_bno055.bus_write = drivers::CBno055Shadow::busWrite;
+        s_bno055.bus_read = drivers::CBno055Shadow::busRead;
+    }
+    else
+    {
+        s_bno055.bus_write = sensor::write;
+        s_bno055.bus_read = sensor::read;
+    }
+    bno055_init(&s_bno055);
+}
+
+/** @brief  Startup of the IMU task: fusion mode and degrees */
+static void startup()
+{
+    u8 l_unit = 0;
+    bno055_set_power_mode(BNO055_POWER_MODE_NORMAL);
+    bno055_set_operation_mode(BNO055_OPERATION_MODE_NDOF);
+    bno055_get_euler_unit(&l_unit);
+    if(l_unit != BNO055_EULER_UNIT_DEG) bno055_set_euler_unit(BNO055_EULER_UNIT_DEG);
+}
+
+/** @brief  Polling of the configuration: page check, operation mode and unit */
+static void poll(uint32_t f_count)
+{
+    u8 l_value;
+    for(uint32_t i = 0; i < f_count; i++)
+    {
+        if(s_bno055.page_id != BNO055_PAGE_ZERO) bno055_write_page_id(BNO055_PAGE_ZERO);
+        bno055_get_operation_mode(&l_value);
+        bno055_get_euler_unit(&l_value);
+    }
+}
+
+/** @brief  Each access of the driver is made on the bus or served by the shadow */
+static void checkAccounting(uint32_t f_direct)
+{
+    const drivers::CBno055Shadow::SStats& l_stats = drivers::CBno055Shadow::getStats();
+    CHECK_EQUAL(sensor::s_reads, l_stats.reads);
+    CHECK_EQUAL(sensor::s_writes, l_stats.writes);
+    CHECK_EQUAL(f_direct, l_stats.reads + l_stats.writes + l_stats.cachedReads + l_stats.skippedWrites);
+}
+
+/** @brief  The startup, the polling and the suspend need less bus accesses and leave the sensor in the same state */
+static void testSequence()
+{
+    u8 l_registers[bno055_shadow_pages][bno055_shadow_registers];
+    uint32_t l_direct[3];
+
+    init(false);
+    startup();
+    l_direct[0] = sensor::accesses();
+    poll(100);
+    l_direct[1] = sensor::accesses() - l_direct[0];
+    bno055_set_power_mode(BNO055_POWER_MODE_SUSPEND);
+    l_direct[2] = sensor::accesses() - l_direct[0] - l_direct[1];
+    memcpy(l_registers, sensor::s_registers, sizeof(l_registers));
+    CHECK_EQUAL(24u, l_direct[0]);
+    CHECK_EQUAL(200u, l_direct[1]);
+    CHECK_EQUAL(9u, l_direct[2]);
+
+    init(true);
+    startup();
+    CHECK_EQUAL(14u, sensor::accesses());
+    checkAccounting(l_direct[0]);
+
+    drivers::CBno055Shadow::resetStats();
+    uint32_t l_before = sensor::accesses();
+    poll(100);
+    CHECK_EQUAL(l_before, sensor::accesses());
+    CHECK_EQUAL(200u, drivers::CBno055Shadow::getStats().cachedReads);
+
+    drivers::CBno055Shadow::resetStats();
+    l_before = sensor::accesses();
+    bno055_set_power_mode(BNO055_POWER_MODE_SUSPEND);
+    CHECK_EQUAL(3u, sensor::accesses() - l_before);
+    CHECK_EQUAL(0u, drivers::CBno055Shadow::getStats().reads);
+
+    CHECK_EQUAL(0, memcmp(l_registers, sensor::s_registers, sizeof(l_registers)));
+    CHECK_EQUAL(BNO055_PAGE_ZERO, sensor::s_page);
+}
+
+/** @brief  The configuration of the page one is kept only in config mode, the sensor changes it in the fusion modes */
+static void testPageOneInFusion()
+{
+    init(true);
+    bno055_set_operation_mode(BNO055_OPERATION_MODE_CONFIG);
+
+    u8 l_range = 0;
+    bno055_set_accel_range(BNO055_ACCEL_RANGE_8G);
+    drivers::CBno055Shadow::resetStats();
+    bno055_get_accel_range(&l_range);
+    CHECK_EQUAL(BNO055_ACCEL_RANGE_8G, l_range);
+    CHECK_EQUAL(0u, drivers::CBno055Shadow::getStats().reads);
+
+    bno055_set_operation_mode(BNO055_OPERATION_MODE_NDOF);
+    sensor::s_registers[BNO055_PAGE_ONE][BNO055_ACCEL_CONFIG_ADDR] = BNO055_ACCEL_RANGE_4G;
+    drivers::CBno055Shadow::resetStats();
+    bno055_get_accel_range(&l_range);
+    CHECK_EQUAL(BNO055_ACCEL_RANGE_4G, l_range);
+    CHECK(drivers::CBno055Shadow::getStats().reads > 0);
+}
+
+/** @brief  The unchanged values aren't written again, the failed write drops the copy of the register */
+static void testWrites()
+{
+    init(true);
+    bno055_set_operation_mode(BNO055_OPERATION_MODE_CONFIG);
+    bno055_set_euler_unit(BNO055_EULER_UNIT_DEG);
+
+    drivers::CBno055Shadow::resetStats();
+    uint32_t l_before = sensor::s_writes;
+    bno055_set_euler_unit(BNO055_EULER_UNIT_DEG);
+    CHECK_EQUAL(l_before, sensor::s_writes);
+    CHECK_EQUAL(1u, drivers::CBno055Shadow::getStats().skippedWrites);
+
+    // The failed write leaves the sensor in an unknown state, the next read has to be made on the bus
+    sensor::s_failWrite = true;
+    bno055_set_euler_unit(BNO055_EULER_UNIT_RAD);
+    drivers::CBno055Shadow::resetStats();
+    u8 l_unit = 0xFF;
+    bno055_get_euler_unit(&l_unit);
+    CHECK_EQUAL(1u, drivers::CBno055Shadow::getStats().reads);
+    CHECK_EQUAL(BNO055_EULER_UNIT_DEG, l_unit);
+
+    // The invalidated copy is read again from the sensor
+    drivers::CBno055Shadow::invalidate();
+    drivers::CBno055Shadow::resetStats();
+    bno055_get_euler_unit(&l_unit);
+    CHECK(drivers::CBno055Shadow::getStats().reads > 0);
+    CHECK_EQUAL(0u, drivers::CBno055Shadow::getStats().cachedReads);
+}
+
+int main()
+{
+    RUN_TEST(testSequence);
+    RUN_TEST(testPageOneInFusion);
+    RUN_TEST(testWrites);
+    return TEST_RESULT();
+}
\ No newline at end of file
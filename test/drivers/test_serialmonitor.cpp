@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+#include <string>
+#include <vector>
+#include <unittest.hpp>
+#include <drivers/serialmonitor.hpp>
+
+/** @brief  Contents received by the subscribers, in the order of the callbacks */
+static std::vector<std::string> s_received;
+
+static void speedCallback(char const * a, char * b)
+{
+    s_received.push_back(std::string("speed:") + a);
+    sprintf(b, "ok");
+}
+
+static void steerCallback(char const * a, char * b)
+{
+    s_received.push_back(std::string("steer:") + a);
+    sprintf(b, "ok");
+}
+
+static const drivers::CSerialMonitor::SSubscriber s_subscribers[] = {
+    {"speed", mbed::callback(speedCallback), drivers::CSerialTransmitter::ID_TEXT},
+    {"steer", mbed::callback(steerCallback), drivers::CSerialTransmitter::ID_TEXT},
+};
+
+/** @brief  Serial monitor on the simulated port, applied by the task manager */
+struct SMonitor
+{
+    SMonitor()
+        : port(USBTX, USBRX, 115200)
+        , transmitter(port, 115200)
+        , monitor(port, transmitter, s_subscribers, 2, 115200)
+        , tasks{&monitor}
+        , manager(tasks, 1, std::chrono::milliseconds(1))
+    {
+        s_received.clear();
+    }
+
+    /** @brief  Receives the text and applies the monitor */
+    void receive(const char* f_text)
+    {
+        port.receive(f_text, strlen(f_text));
+        manager.mainCallback();
+        port.transmit();
+    }
+
+    UnbufferedSerial port;
+    drivers::CSerialTransmitter transmitter;
+    drivers::CSerialMonitor monitor;
+    utils::CTask* tasks[1];
+    utils::CTaskManager manager;
+};
+
+/** @brief  Only the lines started by '#' are dispatched, also after a valid message */
+static void testMessageStart()
+{
+    SMonitor l_monitor;
+
+    l_monitor.receive("speed:1;;\r\n");
+    CHECK(s_received.empty());
+
+    l_monitor.receive("#speed:2;;\r\n");
+    CHECK_EQUAL(1u, (uint32_t)s_received.size());
+
+    l_monitor.receive("speed:3;;\r\n");
+    l_monitor.receive("steer:4;;\r\n");
+    CHECK_EQUAL(1u, (uint32_t)s_received.size());
+
+    // The garbage before the '#' is dropped
+    l_monitor.receive("xx#steer:5;;\r\n");
+    CHECK_EQUAL(2u, (uint32_t)s_received.size());
+    CHECK(s_received.back() == "steer:5;;");
+}
+
+/** @brief  The message split between receptions is dispatched once */
+static void testSplitMessage()
+{
+    SMonitor l_monitor;
+    l_monitor.receive("#spe");
+    l_monitor.receive("ed:7;;\r");
+    CHECK(s_received.empty());
+    l_monitor.receive("\n");
+    CHECK_EQUAL(1u, (uint32_t)s_received.size());
+    CHECK(s_received.back() == "speed:7;;");
+}
+
+/** @brief  The commands of a message are applied in order, none of them with an unknown key */
+static void testMultiCommand()
+{
+    SMonitor l_monitor;
+    l_monitor.receive("#steer:1;;|speed:2;;\r\n");
+    CHECK_EQUAL(2u, (uint32_t)s_received.size());
+    CHECK(s_received[0] == "steer:1;;");
+    CHECK(s_received[1] == "speed:2;;");
+
+    s_received.clear();
+    l_monitor.receive("#steer:1;;|brake:2;;\r\n");
+    l_monitor.receive("#steer:1;;|speed;;\r\n");
+    CHECK(s_received.empty());
+}
+
+int main()
+{
+    RUN_TEST(testMessageStart);
+    RUN_TEST(testSplitMessage);
+    RUN_TEST(testMultiCommand);
+    return TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,247 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+/* Include guard */
+#ifndef MBED_STUB_H
+#define MBED_STUB_H
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <chrono>
+#include <deque>
+#include <functional>
+
+/**
+ * @brief Host stand-in of the parts of mbed-os, which are used by the tested modules. The time is simulated: it's changed only by 
+ * the tests (stub::advance) and by the timed waits of the event flags, so the scheduling can be checked deterministically.
+ */
+namespace stub
+{
+    /** @brief  Simulated time in microseconds */
+    inline uint64_t& timeUs()
+    {
+        static uint64_t s_time = 0;
+        return s_time;
+    }
+
+    /** @brief  Moves the simulated time forward */
+    inline void advance(std::chrono::microseconds f_time)
+    {
+        timeUs() += f_time.count();
+    }
+}; // namespace stub
+
+#define MBED_ASSERT(expr) assert(expr)
+#define osFlagsError        0x80000000U
+#define osFlagsErrorTimeout 0xFFFFFFFEU
+
+namespace mbed
+{
+    /** @brief  Callback with the interface of mbed::Callback */
+    template <typename F> class Callback;
+
+    template <typename R, typename... A>
+    class Callback<R(A...)>
+    {
+        public:
+            Callback() {}
+            Callback(R (*f_function)(A...)) : m_function(f_function) {}
+            template <typename T>
+            Callback(T* f_object, R (T::*f_method)(A...)) : m_function([f_object, f_method](A... f_args) { return (f_object->*f_method)(f_args...); }) {}
+
+            R operator()(A... f_args) const { return m_function(f_args...); }
+            R call(A... f_args) const { return m_function(f_args...); }
+            explicit operator bool() const { return (bool)m_function; }
+        private:
+            std::function<R(A...)> m_function;
+    };
+
+    template <typename T, typename R, typename... A>
+    Callback<R(A...)> callback(T* f_object, R (T::*f_method)(A...)) { return Callback<R(A...)>(f_object, f_method); }
+
+    template <typename R, typename... A>
+    Callback<R(A...)> callback(R (*f_function)(A...)) { return Callback<R(A...)>(f_function); }
+
+    /** @brief  Serial port, the test delivers the received characters and applies the transmit interrupt */
+    class SerialBase
+    {
+        public:
+            enum IrqType
+            {
+                RxIrq = 0,
+                TxIrq
+            };
+    };
+
+    class UnbufferedSerial : public SerialBase
+    {
+        public:
+            UnbufferedSerial(int /* tx */, int /* rx */, int f_baud) : m_baud(f_baud), m_written(0) {}
+            void attach(Callback<void()> f_callback, IrqType f_type = RxIrq) { m_irq[f_type] = f_callback; }
+            void baud(int f_baud) { m_baud = f_baud; }
+            bool readable() { return !m_received.empty(); }
+            bool writeable() { return true; }
+            ssize_t read(void* f_buffer, size_t f_length)
+            {
+                size_t l_length = 0;
+                for(; (l_length < f_length) && !m_received.empty(); l_length++)
+                {
+                    static_cast<char*>(f_buffer)[l_length] = m_received.front();
+                    m_received.pop_front();
+                }
+                return (ssize_t)l_length;
+            }
+            ssize_t write(const void* /* f_buffer */, size_t f_length) { m_written += f_length; return (ssize_t)f_length; }
+
+            /** @brief  The characters are received and the receive interrupt is applied */
+            void receive(const char* f_chars, size_t f_length)
+            {
+                m_received.insert(m_received.end(), f_chars, f_chars + f_length);
+                if(m_irq[RxIrq]) m_irq[RxIrq]();
+            }
+            /** @brief  The transmit interrupt is applied, while it's attached */
+            void transmit()
+            {
+                while(m_irq[TxIrq]) m_irq[TxIrq]();
+            }
+            /** @brief  Number of the transmitted characters */
+            size_t written() const { return m_written; }
+        private:
+            Callback<void()> m_irq[2];
+            int m_baud;
+            std::deque<char> m_received;
+            size_t m_written;
+    };
+
+    /** @brief  Timeout, it isn't applied in the simulated time */
+    class Timeout
+    {
+        public:
+            void attach(Callback<void()> f_callback, std::chrono::microseconds /* f_delay */) { m_callback = f_callback; }
+            void detach() { m_callback = Callback<void()>(); }
+        private:
+            Callback<void()> m_callback;
+    };
+
+    /** @brief  Timer of the simulated time */
+    class Timer
+    {
+        public:
+            void start() {}
+            void stop() {}
+            std::chrono::microseconds elapsed_time() const { return std::chrono::microseconds(stub::timeUs()); }
+    };
+}; // namespace mbed
+
+namespace rtos
+{
+    namespace Kernel
+    {
+        struct Clock
+        {
+            typedef std::chrono::milliseconds duration;
+            typedef duration::rep rep;
+            typedef duration::period period;
+            typedef std::chrono::time_point<Clock> time_point;
+            typedef std::chrono::duration<uint32_t, std::milli> duration_u32;
+            static const bool is_steady = true;
+            static time_point now() { return time_point(std::chrono::milliseconds(stub::timeUs() / 1000)); }
+        };
+    }; // namespace Kernel
+
+    /** @brief  Event flags, the timed wait without set flags passes the whole timeout in the simulated time */
+    class EventFlags
+    {
+        public:
+            EventFlags() : m_flags(0) {}
+            uint32_t set(uint32_t f_flags) { m_flags |= f_flags; return m_flags; }
+            uint32_t wait_any_for(uint32_t f_flags, Kernel::Clock::duration_u32 f_timeout, bool f_clear = true)
+            {
+                uint32_t l_flags = m_flags & f_flags;
+                if(0 == l_flags)
+                {
+                    stub::advance(f_timeout);
+                    return osFlagsErrorTimeout;
+                }
+                if(f_clear) m_flags &= ~l_flags;
+                return l_flags;
+            }
+            uint32_t wait_any(uint32_t f_flags, uint32_t /* f_timeout */ = 0xFFFFFFFFU, bool f_clear = true)
+            {
+                uint32_t l_flags = m_flags & f_flags;
+                assert(l_flags != 0); // nothing would wake up the simulated thread
+                if(f_clear) m_flags &= ~l_flags;
+                return l_flags;
+            }
+        private:
+            uint32_t m_flags;
+    };
+}; // namespace rtos
+
+// Like mbed.h without MBED_NO_GLOBAL_USING_DIRECTIVE
+using namespace mbed;
+using namespace rtos;
+using namespace std;
+
+typedef int PinName;
+#define USBTX 0
+#define USBRX 1
+
+inline uint32_t us_ticker_read()
+{
+    return (uint32_t)stub::timeUs();
+}
+
+inline void core_util_critical_section_enter()
+{
+}
+
+inline void core_util_critical_section_exit()
+{
+}
+
+inline uint32_t core_util_atomic_exchange_u32(volatile uint32_t* f_ptr, uint32_t f_value)
+{
+    uint32_t l_old = *f_ptr;
+    *f_ptr = f_value;
+    return l_old;
+}
+
+inline uint32_t core_util_atomic_fetch_or_u32(volatile uint32_t* f_ptr, uint32_t f_value)
+{
+    uint32_t l_old = *f_ptr;
+    *f_ptr = l_old | f_value;
+    return l_old;
+}
+
+#endif // MBED_STUB_H
\ No newline at end of file
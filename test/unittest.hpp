@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+/* Include guard */
+#ifndef UNIT_TEST_HPP
+#define UNIT_TEST_HPP
+
+#include <stdio.h>
+
+/**
+ * @brief Minimal assertions of the host unit tests.
+ * 
+ * A failed check prints its place and the expression, the test goes on. The main function of a test returns the result of 
+ * TEST_RESULT(), so ctest reports the test failed, when any check failed.
+ */
+namespace unittest
+{
+    /** @brief  Number of the failed checks */
+    inline unsigned int& failures()
+    {
+        static unsigned int s_failures = 0;
+        return s_failures;
+    }
+
+    /** @brief  Counts and prints the failed check */
+    inline void fail(const char* f_file, int f_line, const char* f_expression)
+    {
+        failures()++;
+        printf("%s:%d: check failed: %s\n", f_file, f_line, f_expression);
+    }
+}; // namespace unittest
+
+/** @brief  Checks the condition */
+#define CHECK(cond) do { if(!(cond)) unittest::fail(__FILE__, __LINE__, #cond); } while(0)
+
+/** @brief  Checks the equality of the two values */
+#define CHECK_EQUAL(expected, actual) do { if(!((expected) == (actual))) unittest::fail(__FILE__, __LINE__, #expected " == " #actual); } while(0)
+
+/** @brief  Applies the test function and prints its name */
+#define RUN_TEST(test) do { printf("%s\n", #test); test(); } while(0)
+
+/** @brief  Result of the test executable, zero when all checks passed */
+#define TEST_RESULT() ((unittest::failures() == 0) ? 0 : 1)
+
+#endif // UNIT_TEST_HPP
\ No newline at end of file
@@ -0,0 +1,211 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <chrono>
+#include <utils/binaryframe.hpp>
+#include <utils/textformatter.hpp>
+#include <utils/textparser.hpp>
+
+#define sample_count 1024
+#define round_count 1000
+#define id_battery 0x08
+#define id_imu 0x0A
+#define _64_chars 64
+
+/**
+ * Size and cost of the IMU and battery messages in text and in binary frames. The same samples are written like by CImu and 
+ * CTotalVoltage ("@imu:ROLL;PITCH;HEADING;VX;VY;VZ;;\r\n" against a ID_IMU frame of six s16, "@battery:MV;;\r\n" against a 
+ * ID_BATTERY frame of one u16), then they are read back like by the host: the text with CTextParser, the frame with decode.
+ */
+
+/** @brief  IMU sample: the Euler angles in 1/16 degree, the velocities in mm/s */
+struct SImu
+{
+    int16_t roll, pitch, heading, vx, vy, vz;
+};
+
+static SImu s_imu[sample_count];
+static uint16_t s_battery[sample_count];
+static volatile int32_t s_sink;
+
+/** @brief  Pseudo random samples in the ranges of the sensors */
+static void generate()
+{
+    uint32_t l_seed = 12345;
+    for(uint32_t i = 0; i < sample_count; i++)
+    {
+        int16_t l_values[6];
+        for(uint8_t k = 0; k < 6; k++)
+        {
+            l_seed = l_seed * 1103515245u + 12345u;
+            l_values[k] = (int16_t)((l_seed >> 8) % 5761) - 2880; // +-180 degrees in 1/16 degree, +-2.88 m/s
+        }
+        s_imu[i] = {l_values[0], l_values[1], (int16_t)(l_values[2] + 2880), l_values[3], l_values[4], l_values[5]};
+        s_battery[i] = (uint16_t)(6800 + (l_seed >> 20) % 1600);
+    }
+}
+
+/** @brief  Millidegrees of the raw angle, like CImu */
+static int32_t toMdeg(int16_t f_raw)
+{
+    return (int32_t)f_raw * 1000 / 16;
+}
+
+static uint32_t imuText(const SImu& f_imu, char* f_buffer)
+{
+    utils::CTextFormatter l_text(f_buffer, _64_chars);
+    l_text.append("@imu:").appendFixed(toMdeg(f_imu.roll), 3).appendChar(';').appendFixed(toMdeg(f_imu.pitch), 3).appendChar(';')
+          .appendFixed(toMdeg(f_imu.heading), 3).appendChar(';').appendFixed(f_imu.vx, 3).appendChar(';')
+          .appendFixed(f_imu.vy, 3).appendChar(';').appendFixed(f_imu.vz, 3).append(";;\r\n");
+    return l_text.length();
+}
+
+static uint32_t imuBinary(const SImu& f_imu, uint8_t* f_frame)
+{
+    uint8_t l_payload[12];
+    uint8_t* l_it = utils::CBinaryFrame::putU16(l_payload, (uint16_t)f_imu.roll);
+    l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)f_imu.pitch);
+    l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)f_imu.heading);
+    l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)f_imu.vx);
+    l_it = utils::CBinaryFrame::putU16(l_it, (uint16_t)f_imu.vy);
+    utils::CBinaryFrame::putU16(l_it, (uint16_t)f_imu.vz);
+    return utils::CBinaryFrame::encode(id_imu, l_payload, sizeof(l_payload), f_frame);
+}
+
+static uint32_t batteryText(uint16_t f_battery, char* f_buffer)
+{
+    utils::CTextFormatter l_text(f_buffer, _64_chars);
+    l_text.append("@battery:").appendUnsigned(f_battery).append(";;\r\n");
+    return l_text.length();
+}
+
+static uint32_t batteryBinary(uint16_t f_battery, uint8_t* f_frame)
+{
+    uint8_t l_payload[2];
+    utils::CBinaryFrame::putU16(l_payload, f_battery);
+    return utils::CBinaryFrame::encode(id_battery, l_payload, sizeof(l_payload), f_frame);
+}
+
+/** @brief  Sum of the fields of the text message after the key */
+static int32_t parseText(const char* f_text, uint32_t f_length, uint8_t f_fields)
+{
+    const char* l_content = (const char*)memchr(f_text, ':', f_length) + 1;
+    utils::CTextParser l_parser(l_content, (uint32_t)(f_text + f_length - 4 - l_content)); // without the ";;\r\n"
+    int32_t l_sum = 0;
+    for(uint8_t i = 0; i < f_fields; i++)
+    {
+        int32_t l_value = 0;
+        if(!l_parser.nextFixed(l_value, (f_fields > 1) ? 3 : 0)) return INT32_MIN;
+        l_sum += l_value;
+    }
+    return l_sum;
+}
+
+/** @brief  Sum of the s16 fields of the frame */
+static int32_t parseBinary(uint8_t* f_frame, uint32_t f_length)
+{
+    int32_t l_length = utils::CBinaryFrame::decode(f_frame, f_length - 1); // without the delimiter
+    if(l_length < 1) return INT32_MIN;
+    int32_t l_sum = 0;
+    for(int32_t i = 1; i + 1 < l_length; i += 2)
+    {
+        l_sum += (int16_t)(f_frame[i] | (f_frame[i + 1] << 8));
+    }
+    return l_sum;
+}
+
+typedef std::chrono::steady_clock CClock;
+
+/** @brief  Nanoseconds per message of the passed time */
+static double perMessage(CClock::time_point f_start)
+{
+    std::chrono::duration<double, std::nano> l_time = CClock::now() - f_start;
+    return l_time.count() / ((double)sample_count * round_count);
+}
+
+/** @brief  Measures and prints the text and binary forms of one message */
+template <typename FText, typename FBinary>
+static void compare(const char* f_name, FText f_text, FBinary f_binary, uint8_t f_fields)
+{
+    static char s_texts[sample_count][_64_chars];
+    static uint32_t s_textLengths[sample_count];
+    static uint8_t s_frames[sample_count][binary_frame_max];
+    static uint32_t s_frameLengths[sample_count];
+    uint64_t l_textBytes = 0, l_frameBytes = 0;
+    int32_t l_sum = 0;
+
+    CClock::time_point l_start = CClock::now();
+    for(uint32_t r = 0; r < round_count; r++)
+        for(uint32_t i = 0; i < sample_count; i++) s_textLengths[i] = f_text(i, s_texts[i]);
+    double l_textEncode = perMessage(l_start);
+
+    l_start = CClock::now();
+    for(uint32_t r = 0; r < round_count; r++)
+        for(uint32_t i = 0; i < sample_count; i++) s_frameLengths[i] = f_binary(i, s_frames[i]);
+    double l_binaryEncode = perMessage(l_start);
+
+    l_start = CClock::now();
+    for(uint32_t r = 0; r < round_count; r++)
+        for(uint32_t i = 0; i < sample_count; i++) l_sum += parseText(s_texts[i], s_textLengths[i], f_fields);
+    double l_textParse = perMessage(l_start);
+
+    // The frames are decoded in place, so each round decodes a fresh copy
+    static uint8_t s_copy[binary_frame_max];
+    l_start = CClock::now();
+    for(uint32_t r = 0; r < round_count; r++)
+        for(uint32_t i = 0; i < sample_count; i++)
+        {
+            memcpy(s_copy, s_frames[i], s_frameLengths[i]);
+            l_sum += parseBinary(s_copy, s_frameLengths[i]);
+        }
+    double l_binaryParse = perMessage(l_start);
+    s_sink = l_sum;
+
+    for(uint32_t i = 0; i < sample_count; i++)
+    {
+        l_textBytes += s_textLengths[i];
+        l_frameBytes += s_frameLengths[i];
+    }
+    double l_textSize = (double)l_textBytes / sample_count;
+    double l_frameSize = (double)l_frameBytes / sample_count;
+    printf("%-8s text   %5.1f bytes  encode %6.1f ns  parse %6.1f ns\n", f_name, l_textSize, l_textEncode, l_textParse);
+    printf("%-8s binary %5.1f bytes  encode %6.1f ns  parse %6.1f ns  (%.1fx smaller)\n", f_name, l_frameSize, l_binaryEncode, l_binaryParse, l_textSize / l_frameSize);
+}
+
+int main()
+{
+    generate();
+    compare("imu", [](uint32_t i, char* b) { return imuText(s_imu[i], b); }, [](uint32_t i, uint8_t* f) { return imuBinary(s_imu[i], f); }, 6);
+    compare("battery", [](uint32_t i, char* b) { return batteryText(s_battery[i], b); }, [](uint32_t i, uint8_t* f) { return batteryBinary(s_battery[i], f); }, 1);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <chrono>
+#include <utils/ringbuffer.hpp>
+#include <utils/queue.hpp>
+
+#define chunk_size 64
+#define total_chars (64u * 1024u * 1024u)
+
+/**
+ * Throughput of the lock-free ring buffer against the old queue, which was replaced by it in the serial drivers. The producer 
+ * writes chunks of chunk_size characters (like a serial message), the consumer reads them, one by one and in bulk.
+ */
+
+/** @brief  Millions of characters per second of the passed time */
+static double toRate(std::chrono::steady_clock::time_point f_start, uint32_t f_chars)
+{
+    std::chrono::duration<double> l_time = std::chrono::steady_clock::now() - f_start;
+    return f_chars / l_time.count() / 1e6;
+}
+
+/** @brief  Chunk of the producer */
+static char s_chunk[chunk_size];
+
+/** @brief  Old queue, bulk push and single pop */
+static double benchQueue(uint32_t& f_sum)
+{
+    static utils::CQueue<char, 255> s_queue;
+    std::chrono::steady_clock::time_point l_start = std::chrono::steady_clock::now();
+    for(uint32_t l_chars = 0; l_chars < total_chars; l_chars += chunk_size)
+    {
+        s_queue.push(s_chunk, chunk_size);
+        while(!s_queue.isEmpty()) f_sum += (uint8_t)s_queue.pop();
+    }
+    return toRate(l_start, total_chars);
+}
+
+/** @brief  Ring buffer, bulk push and single pop */
+static double benchRingSingle(uint32_t& f_sum)
+{
+    static utils::CRingBuffer<char, 256> s_buffer;
+    std::chrono::steady_clock::time_point l_start = std::chrono::steady_clock::now();
+    char l_item;
+    for(uint32_t l_chars = 0; l_chars < total_chars; l_chars += chunk_size)
+    {
+        s_buffer.push(s_chunk, chunk_size);
+        while(s_buffer.pop(l_item)) f_sum += (uint8_t)l_item;
+    }
+    return toRate(l_start, total_chars);
+}
+
+/** @brief  Ring buffer, bulk push and bulk pop */
+static double benchRingBulk(uint32_t& f_sum)
+{
+    static utils::CRingBuffer<char, 256> s_buffer;
+    char l_items[chunk_size];
+    std::chrono::steady_clock::time_point l_start = std::chrono::steady_clock::now();
+    for(uint32_t l_chars = 0; l_chars < total_chars; l_chars += chunk_size)
+    {
+        s_buffer.push(s_chunk, chunk_size);
+        uint32_t l_len = s_buffer.pop(l_items, chunk_size);
+        for(uint32_t i = 0; i < l_len; i++) f_sum += (uint8_t)l_items[i];
+    }
+    return toRate(l_start, total_chars);
+}
+
+/** @brief  Ring buffer, bulk push and zero-copy peek/consume */
+static double benchRingPeek(uint32_t& f_sum)
+{
+    static utils::CRingBuffer<char, 256> s_buffer;
+    const char* l_items;
+    std::chrono::steady_clock::time_point l_start = std::chrono::steady_clock::now();
+    for(uint32_t l_chars = 0; l_chars < total_chars; l_chars += chunk_size)
+    {
+        s_buffer.push(s_chunk, chunk_size);
+        uint32_t l_len;
+        while((l_len = s_buffer.peek(l_items)) > 0)
+        {
+            for(uint32_t i = 0; i < l_len; i++) f_sum += (uint8_t)l_items[i];
+            s_buffer.consume(l_len);
+        }
+    }
+    return toRate(l_start, total_chars);
+}
+
+int main()
+{
+    for(uint32_t i = 0; i < chunk_size; i++) s_chunk[i] = (char)('0' + i % 64);
+
+    // Each variant has to read the same characters, the sums are compared
+    uint32_t l_sums[4] = {0, 0, 0, 0};
+    printf("CQueue<char,255>      push(chunk), pop()         %8.1f Mchar/s\n", benchQueue(l_sums[0]));
+    printf("CRingBuffer<char,256> push(chunk), pop(item)     %8.1f Mchar/s\n", benchRingSingle(l_sums[1]));
+    printf("CRingBuffer<char,256> push(chunk), pop(chunk)    %8.1f Mchar/s\n", benchRingBulk(l_sums[2]));
+    printf("CRingBuffer<char,256> push(chunk), peek/consume  %8.1f Mchar/s\n", benchRingPeek(l_sums[3]));
+
+    bool l_same = (l_sums[0] == l_sums[1]) && (l_sums[0] == l_sums[2]) && (l_sums[0] == l_sums[3]);
+    if(!l_same) printf("The variants read different characters\n");
+    return l_same ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,200 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+#include <vector>
+#include <utils/taskmanager.hpp>
+
+#define simulated_ms 10000
+#define round_count  20
+
+/**
+ * Cost of a pass of the task manager with 4, 16 and 32 tasks: the heap of the manager against a linear scan of all the tasks, 
+ * which applies the same deadline logic. The tasks do nothing and take no simulated time, so the times show the cost of the 
+ * scheduling, measured with the host clock. Each pass sleeps until the next deadline in the simulated time.
+ */
+
+/** @brief  Periods of the tasks in milliseconds, repeated for the longer lists */
+static const uint16_t s_periods[] = {1, 2, 5, 10, 20, 50, 100, 200};
+
+/** @brief  Task, which counts its runs */
+class CBenchTask : public utils::CTask
+{
+    public:
+        CBenchTask(std::chrono::milliseconds f_period)
+            : utils::CTask(f_period)
+            , m_runCount(0)
+        {
+        }
+
+        /** @brief  Number of runs */
+        uint32_t m_runCount;
+    private:
+        virtual void _run()
+        {
+            m_runCount++;
+        }
+};
+
+/** @brief  Scheduler visiting all the tasks at each pass, the reference of the heap. It reads the timer like the manager, for 
+ *  the start latency of each run and for the idle time, so the difference is the selection of the due tasks. */
+class CLinearScan
+{
+    public:
+        CLinearScan(utils::CTask** f_taskList, uint8_t f_taskCount)
+            : m_taskList(f_taskList)
+            , m_taskCount(f_taskCount)
+            , m_deadlines(f_taskCount)
+            , m_timeSum(0)
+        {
+            m_timer.start();
+            for(uint8_t i = 0; i < m_taskCount; i++) m_deadlines[i] = getNow() + s_periods[i % 8];
+        }
+
+        /** @brief  Applies the due tasks, then sleeps until the earliest deadline */
+        void mainCallback()
+        {
+            uint32_t l_now = getNow();
+            uint32_t l_next = l_now + UINT16_MAX;
+            for(uint8_t i = 0; i < m_taskCount; i++)
+            {
+                uint32_t l_period = s_periods[i % 8];
+                if((int32_t)(l_now - m_deadlines[i]) >= 0)
+                {
+                    m_timeSum += (uint32_t)m_timer.elapsed_time().count() - m_deadlines[i] * 1000;
+                    m_deadlines[i] += l_period;
+                    if((int32_t)(l_now - m_deadlines[i]) >= 0)
+                    {
+                        m_deadlines[i] += ((l_now - m_deadlines[i]) / l_period + 1) * l_period;
+                    }
+                    m_taskList[i]->timerCallback();
+                    m_taskList[i]->run();
+                }
+                if((int32_t)(m_deadlines[i] - l_next) < 0) l_next = m_deadlines[i];
+            }
+            int64_t l_remaining = (int64_t)l_next * 1000 - (int64_t)stub::timeUs();
+            if(l_remaining > 0)
+            {
+                uint64_t l_start = m_timer.elapsed_time().count();
+                stub::advance(std::chrono::microseconds(l_remaining));
+                m_timeSum += m_timer.elapsed_time().count() - l_start;
+            }
+        }
+    private:
+        static uint32_t getNow() { return (uint32_t)(stub::timeUs() / 1000); }
+
+        utils::CTask** m_taskList;
+        uint8_t m_taskCount;
+        std::vector<uint32_t> m_deadlines;
+        Timer m_timer;
+        /** @brief  Sum of the latencies and idle times, like the statistics of the manager */
+        uint64_t m_timeSum;
+};
+
+typedef std::chrono::steady_clock CClock;
+
+/** @brief  Scheduler of the task list */
+template <typename T>
+static T* create(utils::CTask** f_taskList, uint8_t f_taskCount);
+
+template <>
+utils::CTaskManager* create<utils::CTaskManager>(utils::CTask** f_taskList, uint8_t f_taskCount)
+{
+    return new utils::CTaskManager(f_taskList, f_taskCount, std::chrono::milliseconds(1));
+}
+
+template <>
+CLinearScan* create<CLinearScan>(utils::CTask** f_taskList, uint8_t f_taskCount)
+{
+    return new CLinearScan(f_taskList, f_taskCount);
+}
+
+/** @brief  Result of a scheduler: host time per pass and number of the task runs */
+struct SResult
+{
+    double passNs;
+    uint32_t passes;
+    uint32_t runs;
+};
+
+/** @brief  Applies the scheduler for the simulated duration, a new task list and scheduler for each round */
+template <typename T>
+static SResult measure(uint8_t f_taskCount)
+{
+    SResult l_result = {0, 0, 0};
+    std::chrono::duration<double, std::nano> l_time(0);
+    for(uint32_t r = 0; r < round_count; r++)
+    {
+        stub::timeUs() = 0;
+        std::vector<CBenchTask*> l_tasks;
+        std::vector<utils::CTask*> l_list;
+        for(uint8_t i = 0; i < f_taskCount; i++)
+        {
+            l_tasks.push_back(new CBenchTask(std::chrono::milliseconds(s_periods[i % 8])));
+            l_list.push_back(l_tasks[i]);
+        }
+        T* l_scheduler = create<T>(l_list.data(), f_taskCount);
+
+        uint32_t l_passes = 0;
+        CClock::time_point l_start = CClock::now();
+        while(stub::timeUs() < (uint64_t)simulated_ms * 1000)
+        {
+            l_scheduler->mainCallback();
+            l_passes++;
+        }
+        l_time += CClock::now() - l_start;
+
+        l_result.passes += l_passes;
+        for(uint8_t i = 0; i < f_taskCount; i++)
+        {
+            l_result.runs += l_tasks[i]->m_runCount;
+            delete l_tasks[i];
+        }
+        delete l_scheduler;
+    }
+    l_result.passNs = l_time.count() / l_result.passes;
+    return l_result;
+}
+
+int main()
+{
+    const uint8_t l_counts[] = {4, 16, 32};
+    bool l_same = true;
+
+    printf("tasks  runs/pass  linear scan ns/pass  heap ns/pass\n");
+    for(uint8_t l_count : l_counts)
+    {
+        SResult l_linear = measure<CLinearScan>(l_count);
+        SResult l_heap = measure<utils::CTaskManager>(l_count);
+        l_same = l_same && (l_linear.runs == l_heap.runs) && (l_linear.passes == l_heap.passes);
+        printf("%5u  %9.2f  %19.1f  %12.1f\n", l_count, (double)l_heap.runs / l_heap.passes, l_linear.passNs, l_heap.passNs);
+    }
+    if(!l_same) printf("the schedulers applied different runs\n");
+    return l_same ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <chrono>
+#include <utils/textformatter.hpp>
+
+#define sample_count 1024
+#define round_count 1000
+#define _200_chars 200
+
+/**
+ * Cost of the IMU and telemetry lines with CTextFormatter against snprintf, which it replaced. The snprintf formats write 
+ * the sign separately, so also the values between -1 and 0 are correct and both texts have to be equal.
+ */
+
+/** @brief  Fields of the telemetry line: 6 x 3 decimals, voltage, current, 3 x 2 decimals, 2 integers */
+static const uint8_t s_decimals[13] = {3, 3, 3, 3, 3, 3, 0, 0, 2, 2, 2, 0, 0};
+
+static int32_t s_values[sample_count][13];
+static uint32_t s_times[sample_count];
+static volatile uint32_t s_sink;
+
+/** @brief  Pseudo random values in the ranges of the fields */
+static void generate()
+{
+    uint32_t l_seed = 12345;
+    for(uint32_t i = 0; i < sample_count; i++)
+    {
+        for(uint8_t k = 0; k < 13; k++)
+        {
+            l_seed = l_seed * 1103515245u + 12345u;
+            int32_t l_random = (int32_t)(l_seed >> 8);
+            if(k < 6) s_values[i][k] = l_random % 360001 - 180000;   // millidegrees, mm/s
+            else if(k < 8) s_values[i][k] = l_random % 10000;        // mV, mA
+            else if(k < 11) s_values[i][k] = l_random % 10001;       // hundredths of percent
+            else s_values[i][k] = l_random % 2000;                   // us
+        }
+        s_times[i] = l_seed;
+    }
+}
+
+/** @brief  Sign, integer and fraction of a fixed-point value for snprintf */
+#define fixed_args(value, scale) ((value) < 0) ? "-" : "", (int)(((value) < 0 ? -(int64_t)(value) : (value)) / (scale)), (int)(((value) < 0 ? -(int64_t)(value) : (value)) % (scale))
+
+static uint32_t imuFormatter(const int32_t* f_values, char* f_buffer)
+{
+    utils::CTextFormatter l_text(f_buffer, _200_chars);
+    l_text.append("@imu:").appendFixed(f_values[0], 3).appendChar(';').appendFixed(f_values[1], 3).appendChar(';')
+          .appendFixed(f_values[2], 3).appendChar(';').appendFixed(f_values[3], 3).appendChar(';')
+          .appendFixed(f_values[4], 3).appendChar(';').appendFixed(f_values[5], 3).append(";;\r\n");
+    return l_text.length();
+}
+
+static uint32_t imuSnprintf(const int32_t* f_values, char* f_buffer)
+{
+    return (uint32_t)snprintf(f_buffer, _200_chars, "@imu:%s%d.%03d;%s%d.%03d;%s%d.%03d;%s%d.%03d;%s%d.%03d;%s%d.%03d;;\r\n",
+        fixed_args(f_values[0], 1000), fixed_args(f_values[1], 1000), fixed_args(f_values[2], 1000),
+        fixed_args(f_values[3], 1000), fixed_args(f_values[4], 1000), fixed_args(f_values[5], 1000));
+}
+
+static uint32_t telemetryFormatter(uint32_t f_time, const int32_t* f_values, char* f_buffer)
+{
+    utils::CTextFormatter l_text(f_buffer, _200_chars);
+    l_text.append("@telemetry:").appendUnsigned(f_time).appendChar(';').appendUnsigned(0x8F);
+    for(uint8_t i = 0; i < 13; i++) l_text.appendChar(';').appendFixed(f_values[i], s_decimals[i]);
+    l_text.append(";;\r\n");
+    return l_text.length();
+}
+
+static uint32_t telemetrySnprintf(uint32_t f_time, const int32_t* f_values, char* f_buffer)
+{
+    return (uint32_t)snprintf(f_buffer, _200_chars, "@telemetry:%u;%u;%s%d.%03d;%s%d.%03d;%s%d.%03d;%s%d.%03d;%s%d.%03d;%s%d.%03d;%d;%d;"
+        "%s%d.%02d;%s%d.%02d;%s%d.%02d;%d;%d;;\r\n", (unsigned)f_time, 0x8Fu,
+        fixed_args(f_values[0], 1000), fixed_args(f_values[1], 1000), fixed_args(f_values[2], 1000),
+        fixed_args(f_values[3], 1000), fixed_args(f_values[4], 1000), fixed_args(f_values[5], 1000),
+        (int)f_values[6], (int)f_values[7],
+        fixed_args(f_values[8], 100), fixed_args(f_values[9], 100), fixed_args(f_values[10], 100),
+        (int)f_values[11], (int)f_values[12]);
+}
+
+typedef std::chrono::steady_clock CClock;
+
+/** @brief  Nanoseconds per line of the function applied on all samples */
+template <typename F>
+static double measure(F f_format)
+{
+    static char s_buffer[_200_chars];
+    uint32_t l_length = 0;
+    CClock::time_point l_start = CClock::now();
+    for(uint32_t r = 0; r < round_count; r++)
+    {
+        for(uint32_t i = 0; i < sample_count; i++) l_length += f_format(i, s_buffer);
+    }
+    std::chrono::duration<double, std::nano> l_time = CClock::now() - l_start;
+    s_sink = l_length;
+    return l_time.count() / ((double)sample_count * round_count);
+}
+
+/** @brief  Both functions give the same text for all samples */
+template <typename F1, typename F2>
+static bool isSame(F1 f_first, F2 f_second)
+{
+    char l_first[_200_chars], l_second[_200_chars];
+    for(uint32_t i = 0; i < sample_count; i++)
+    {
+        f_first(i, l_first);
+        f_second(i, l_second);
+        if(strcmp(l_first, l_second) != 0)
+        {
+            printf("different texts:\n%s%s", l_first, l_second);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    generate();
+    auto l_imuFormatter = [](uint32_t i, char* b) { return imuFormatter(s_values[i], b); };
+    auto l_imuSnprintf = [](uint32_t i, char* b) { return imuSnprintf(s_values[i], b); };
+    auto l_telemetryFormatter = [](uint32_t i, char* b) { return telemetryFormatter(s_times[i], s_values[i], b); };
+    auto l_telemetrySnprintf = [](uint32_t i, char* b) { return telemetrySnprintf(s_times[i], s_values[i], b); };
+
+    bool l_same = isSame(l_imuFormatter, l_imuSnprintf) && isSame(l_telemetryFormatter, l_telemetrySnprintf);
+
+    double l_formatter = measure(l_imuFormatter);
+    double l_snprintf = measure(l_imuSnprintf);
+    printf("imu        snprintf %6.1f ns  CTextFormatter %6.1f ns  speed-up %4.1fx\n", l_snprintf, l_formatter, l_snprintf / l_formatter);
+    l_formatter = measure(l_telemetryFormatter);
+    l_snprintf = measure(l_telemetrySnprintf);
+    printf("telemetry  snprintf %6.1f ns  CTextFormatter %6.1f ns  speed-up %4.1fx\n", l_snprintf, l_formatter, l_snprintf / l_formatter);
+    return l_same ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <chrono>
+#include <utils/textparser.hpp>
+
+#define iteration_count 2000000
+
+/**
+ * Parse cost of the command contents with the sscanf calls, which were replaced by CTextParser in the callbacks of the robot 
+ * state machine and of the kl manager. The contents are the ones given to the callbacks, after the key of the message.
+ */
+
+/** @brief  Contents of the messages, in a writable buffer, so the compiler can't evaluate the parsing at compile time */
+static char s_speed[] = "150;;";
+static char s_steer[] = "-120;;";
+static char s_vcd[] = "150;-50;30;;";
+static char s_kl[] = "30;;";
+
+/** @brief  Sum of the parsed values, both parsers have to give the same one */
+static volatile int32_t s_sink;
+
+/** @brief  Nanoseconds per call of the parse function */
+template <typename F>
+static double measure(F f_parse)
+{
+    int32_t l_sum = 0;
+    std::chrono::steady_clock::time_point l_start = std::chrono::steady_clock::now();
+    for(uint32_t i = 0; i < iteration_count; i++)
+    {
+        l_sum += f_parse();
+    }
+    std::chrono::duration<double, std::nano> l_time = std::chrono::steady_clock::now() - l_start;
+    s_sink = l_sum;
+    return l_time.count() / iteration_count;
+}
+
+/** @brief  Prints one line of the comparison */
+static bool report(const char* f_name, double f_sscanf, int32_t f_sscanfSum, double f_parser, int32_t f_parserSum)
+{
+    printf("%-6s sscanf %7.1f ns  CTextParser %7.1f ns  speed-up %5.1fx\n", f_name, f_sscanf, f_parser, f_sscanf / f_parser);
+    if(f_sscanfSum != f_parserSum) printf("%-6s the parsers gave different values\n", f_name);
+    return f_sscanfSum == f_parserSum;
+}
+
+int main()
+{
+    bool l_same = true;
+    double l_sscanf, l_parser;
+    int32_t l_sscanfSum, l_parserSum;
+
+    // #speed:150;;
+    l_sscanf = measure([]() { int l_speed = 0; sscanf(s_speed, "%d", &l_speed); return (int32_t)l_speed; });
+    l_sscanfSum = s_sink;
+    l_parser = measure([]() { int32_t l_speed = 0; utils::CTextParser(s_speed).next(l_speed); return l_speed; });
+    l_parserSum = s_sink;
+    l_same &= report("speed", l_sscanf, l_sscanfSum, l_parser, l_parserSum);
+
+    // #steer:-120;;
+    l_sscanf = measure([]() { int l_angle = 0; sscanf(s_steer, "%d", &l_angle); return (int32_t)l_angle; });
+    l_sscanfSum = s_sink;
+    l_parser = measure([]() { int32_t l_angle = 0; utils::CTextParser(s_steer).next(l_angle); return l_angle; });
+    l_parserSum = s_sink;
+    l_same &= report("steer", l_sscanf, l_sscanfSum, l_parser, l_parserSum);
+
+    // #vcd:150;-50;30;;
+    l_sscanf = measure([]() {
+        int l_speed = 0, l_steer = 0; uint8_t l_time = 0;
+        sscanf(s_vcd, "%d;%d;%hhu", &l_speed, &l_steer, &l_time);
+        return (int32_t)(l_speed + l_steer + l_time);
+    });
+    l_sscanfSum = s_sink;
+    l_parser = measure([]() {
+        int32_t l_speed = 0, l_steer = 0; uint8_t l_time = 0;
+        utils::CTextParser l_text(s_vcd);
+        (void)(l_text.next(l_speed) && l_text.next(l_steer) && l_text.nextAs<uint8_t>(l_time, 0, UINT8_MAX));
+        return (int32_t)(l_speed + l_steer + l_time);
+    });
+    l_parserSum = s_sink;
+    l_same &= report("vcd", l_sscanf, l_sscanfSum, l_parser, l_parserSum);
+
+    // #kl:30;;
+    l_sscanf = measure([]() { uint8_t l_kl = 0; sscanf(s_kl, "%hhu", &l_kl); return (int32_t)l_kl; });
+    l_sscanfSum = s_sink;
+    l_parser = measure([]() { uint8_t l_kl = 0; utils::CTextParser(s_kl).nextAs<uint8_t>(l_kl, 0, UINT8_MAX); return (int32_t)l_kl; });
+    l_parserSum = s_sink;
+    l_same &= report("kl", l_sscanf, l_sscanfSum, l_parser, l_parserSum);
+
+    return l_same ? 0 : 1;
+}
\ No newline at end of file
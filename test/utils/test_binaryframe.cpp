@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+#include <string.h>
+#include <unittest.hpp>
+#include <utils/binaryframe.hpp>
+
+/** @brief  Check value of the CRC-16/CCITT-FALSE and the continuation with the CRC of the previous data */
+static void testCrc16()
+{
+    const uint8_t l_data[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    CHECK_EQUAL(0x29B1, utils::CBinaryFrame::crc16(l_data, sizeof(l_data)));
+    CHECK_EQUAL(0x29B1, utils::CBinaryFrame::crc16(&l_data[4], 5, utils::CBinaryFrame::crc16(l_data, 4)));
+    CHECK_EQUAL(0xFFFF, utils::CBinaryFrame::crc16(l_data, 0));
+}
+
+/** @brief  Encoded frames of known payloads */
+static void testEncodeVectors()
+{
+    uint8_t l_frame[binary_frame_max];
+
+    // Zero in the payload: ID 0x11, payload 22 00 33, CRC 0x0745
+    const uint8_t l_payload[] = {0x22, 0x00, 0x33};
+    const uint8_t l_expected[] = {0x03, 0x11, 0x22, 0x04, 0x33, 0x45, 0x07, 0x00};
+    CHECK_EQUAL(sizeof(l_expected), utils::CBinaryFrame::encode(0x11, l_payload, sizeof(l_payload), l_frame));
+    CHECK_EQUAL(0, memcmp(l_frame, l_expected, sizeof(l_expected)));
+
+    // Empty payload: ID 0x05, CRC 0xB155
+    const uint8_t l_expectedEmpty[] = {0x04, 0x05, 0x55, 0xB1, 0x00};
+    CHECK_EQUAL(sizeof(l_expectedEmpty), utils::CBinaryFrame::encode(0x05, l_payload, 0, l_frame));
+    CHECK_EQUAL(0, memcmp(l_frame, l_expectedEmpty, sizeof(l_expectedEmpty)));
+
+    // Too long payload
+    uint8_t l_long[binary_payload_max + 1] = {0};
+    CHECK_EQUAL(0u, utils::CBinaryFrame::encode(0x01, l_long, sizeof(l_long), l_frame));
+}
+
+/** @brief  Payloads of each length and pattern are decoded to the same identifier and payload */
+static void testRoundTrip()
+{
+    uint8_t l_payload[binary_payload_max];
+    uint8_t l_frame[binary_frame_max];
+
+    for(uint8_t l_pattern = 0; l_pattern < 3; l_pattern++)
+    {
+        for(uint32_t l_length = 0; l_length <= binary_payload_max; l_length++)
+        {
+            for(uint32_t i = 0; i < l_length; i++)
+            {
+                if(0 == l_pattern) l_payload[i] = 0;                         // only zeros
+                else if(1 == l_pattern) l_payload[i] = (uint8_t)(1 + i % 255); // no zero
+                else l_payload[i] = (uint8_t)(i * 37);                         // mixed
+            }
+
+            uint32_t l_encoded = utils::CBinaryFrame::encode(0xA5, l_payload, l_length, l_frame);
+            CHECK(l_encoded > 0);
+            CHECK(l_encoded <= binary_frame_max);
+            // The delimiter is the only zero byte
+            CHECK_EQUAL(0, l_frame[l_encoded - 1]);
+            CHECK(memchr(l_frame, 0, l_encoded - 1) == NULL);
+
+            CHECK_EQUAL((int32_t)(l_length + 1), utils::CBinaryFrame::decode(l_frame, l_encoded - 1));
+            CHECK_EQUAL(0xA5, l_frame[0]);
+            CHECK_EQUAL(0, memcmp(&l_frame[1], l_payload, l_length));
+        }
+    }
+}
+
+/** @brief  The corrupted frames are rejected */
+static void testCorrupted()
+{
+    const uint8_t l_payload[] = {0x22, 0x00, 0x33};
+    uint8_t l_frame[binary_frame_max];
+    uint32_t l_encoded = utils::CBinaryFrame::encode(0x11, l_payload, sizeof(l_payload), l_frame) - 1;
+
+    // Changed byte of the payload, the CRC doesn't match
+    uint8_t l_copy[binary_frame_max];
+    memcpy(l_copy, l_frame, l_encoded);
+    l_copy[4] ^= 0x01;
+    CHECK_EQUAL(-1, utils::CBinaryFrame::decode(l_copy, l_encoded));
+
+    // Zero byte inside the frame
+    memcpy(l_copy, l_frame, l_encoded);
+    l_copy[2] = 0;
+    CHECK_EQUAL(-1, utils::CBinaryFrame::decode(l_copy, l_encoded));
+
+    // Block longer than the frame
+    memcpy(l_copy, l_frame, l_encoded);
+    CHECK_EQUAL(-1, utils::CBinaryFrame::decode(l_copy, l_encoded - 1));
+
+    // Shorter than the identifier and the CRC
+    uint8_t l_short[] = {0x02, 0x05};
+    CHECK_EQUAL(-1, utils::CBinaryFrame::decode(l_short, sizeof(l_short)));
+    CHECK_EQUAL(-1, utils::CBinaryFrame::decode(l_short, 0));
+}
+
+int main()
+{
+    RUN_TEST(testCrc16);
+    RUN_TEST(testEncodeVectors);
+    RUN_TEST(testRoundTrip);
+    RUN_TEST(testCorrupted);
+    return TEST_RESULT();
+}
\ No newline at end of file
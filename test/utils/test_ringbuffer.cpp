@@ -0,0 +1,194 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+#include <string.h>
+#include <unittest.hpp>
+#include <utils/ringbuffer.hpp>
+
+#define capacity 8
+
+typedef utils::CRingBuffer<char, capacity> CBuffer;
+
+/** @brief  Moves the counters forward, so the next element is stored at the position */
+static void moveTo(CBuffer& f_buffer, uint32_t f_position)
+{
+    char l_item;
+    for(uint32_t i = 0; i < f_position; i++)
+    {
+        f_buffer.push('x');
+        f_buffer.pop(l_item);
+    }
+}
+
+/** @brief  The new buffer is empty, nothing can be read from it */
+static void testEmpty()
+{
+    CBuffer l_buffer;
+    char l_item = 'a';
+    char l_items[capacity];
+    const char* l_peeked;
+
+    CHECK(l_buffer.isEmpty());
+    CHECK(!l_buffer.isFull());
+    CHECK_EQUAL(0u, l_buffer.getSize());
+    CHECK_EQUAL((uint32_t)capacity, l_buffer.getCapacity());
+    CHECK(!l_buffer.pop(l_item));
+    CHECK_EQUAL('a', l_item);
+    CHECK_EQUAL(0u, l_buffer.pop(l_items, capacity));
+    CHECK_EQUAL(0u, l_buffer.peek(l_peeked));
+}
+
+/** @brief  All the N elements can be used, the elements over the capacity are dropped */
+static void testFull()
+{
+    CBuffer l_buffer;
+    for(char i = 0; i < capacity; i++)
+    {
+        CHECK(l_buffer.push((char)('a' + i)));
+    }
+    CHECK(l_buffer.isFull());
+    CHECK(!l_buffer.isEmpty());
+    CHECK_EQUAL((uint32_t)capacity, l_buffer.getSize());
+    CHECK(!l_buffer.push('z'));
+    CHECK_EQUAL(0u, l_buffer.push("yz", 2));
+
+    // The dropped elements didn't overwrite the stored ones
+    char l_item;
+    for(char i = 0; i < capacity; i++)
+    {
+        CHECK(l_buffer.pop(l_item));
+        CHECK_EQUAL((char)('a' + i), l_item);
+    }
+    CHECK(l_buffer.isEmpty());
+}
+
+/** @brief  The bulk push stores only the elements, which fit, the bulk pop gives only the stored elements */
+static void testPartialBulk()
+{
+    CBuffer l_buffer;
+    CHECK_EQUAL(5u, l_buffer.push("abcde", 5));
+    CHECK_EQUAL(3u, l_buffer.push("fghij", 5));
+    CHECK(l_buffer.isFull());
+
+    char l_items[2 * capacity] = {0};
+    CHECK_EQUAL((uint32_t)capacity, l_buffer.pop(l_items, sizeof(l_items)));
+    CHECK_EQUAL(0, memcmp(l_items, "abcdefgh", capacity));
+    CHECK(l_buffer.isEmpty());
+}
+
+/** @brief  The order of the elements is kept, while the counters go around the buffer several times */
+static void testWrapAround()
+{
+    CBuffer l_buffer;
+    char l_next = 0;
+    char l_expected = 0;
+    char l_item;
+
+    // Different fill levels, so the seam is crossed at different positions
+    for(uint32_t l_round = 0; l_round < 10 * capacity; l_round++)
+    {
+        uint32_t l_count = 1 + l_round % capacity;
+        for(uint32_t i = 0; i < l_count; i++)
+        {
+            CHECK(l_buffer.push(l_next++));
+        }
+        CHECK_EQUAL(l_count, l_buffer.getSize());
+        for(uint32_t i = 0; i < l_count; i++)
+        {
+            CHECK(l_buffer.pop(l_item));
+            CHECK_EQUAL(l_expected, l_item);
+            l_expected++;
+        }
+        CHECK(l_buffer.isEmpty());
+    }
+}
+
+/** @brief  The bulk push and pop copy the elements across the end of the buffer */
+static void testBulkAcrossSeam()
+{
+    CBuffer l_buffer;
+    moveTo(l_buffer, capacity - 3);
+
+    CHECK_EQUAL(6u, l_buffer.push("abcdef", 6));
+    CHECK_EQUAL(6u, l_buffer.getSize());
+
+    char l_items[capacity] = {0};
+    CHECK_EQUAL(6u, l_buffer.pop(l_items, capacity));
+    CHECK_EQUAL(0, memcmp(l_items, "abcdef", 6));
+    CHECK(l_buffer.isEmpty());
+
+    // Full buffer, which starts in the middle
+    CHECK_EQUAL((uint32_t)capacity, l_buffer.push("ABCDEFGHIJ", 10));
+    CHECK(l_buffer.isFull());
+    CHECK_EQUAL((uint32_t)capacity, l_buffer.pop(l_items, capacity));
+    CHECK_EQUAL(0, memcmp(l_items, "ABCDEFGH", capacity));
+}
+
+/** @brief  The peek gives the contiguous part until the end of the buffer, the rest after consuming it */
+static void testPeekConsume()
+{
+    CBuffer l_buffer;
+    moveTo(l_buffer, capacity - 3);
+    CHECK_EQUAL(5u, l_buffer.push("abcde", 5));
+
+    const char* l_peeked = NULL;
+    CHECK_EQUAL(3u, l_buffer.peek(l_peeked));
+    CHECK_EQUAL(0, memcmp(l_peeked, "abc", 3));
+
+    // Peeking doesn't remove the elements
+    CHECK_EQUAL(5u, l_buffer.getSize());
+    CHECK_EQUAL(3u, l_buffer.peek(l_peeked));
+
+    // Partial consume
+    l_buffer.consume(1);
+    CHECK_EQUAL(2u, l_buffer.peek(l_peeked));
+    CHECK_EQUAL(0, memcmp(l_peeked, "bc", 2));
+    l_buffer.consume(2);
+
+    CHECK_EQUAL(2u, l_buffer.peek(l_peeked));
+    CHECK_EQUAL(0, memcmp(l_peeked, "de", 2));
+    l_buffer.consume(2);
+    CHECK(l_buffer.isEmpty());
+    CHECK_EQUAL(0u, l_buffer.peek(l_peeked));
+
+    // The consumed space can be used by the producer
+    CHECK_EQUAL((uint32_t)capacity, l_buffer.push("01234567", capacity));
+}
+
+int main()
+{
+    RUN_TEST(testEmpty);
+    RUN_TEST(testFull);
+    RUN_TEST(testPartialBulk);
+    RUN_TEST(testWrapAround);
+    RUN_TEST(testBulkAcrossSeam);
+    RUN_TEST(testPeekConsume);
+    return TEST_RESULT();
+}
\ No newline at end of file
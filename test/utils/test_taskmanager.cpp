@@ -0,0 +1,194 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+#include <vector>
+#include <unittest.hpp>
+#include <utils/taskmanager.hpp>
+
+/** @brief  Task, which records the simulated time of its runs */
+class CTestTask : public utils::CTask
+{
+    public:
+        CTestTask(std::chrono::milliseconds f_period)
+            : utils::CTask(f_period)
+            , m_runTime(0)
+        {
+        }
+
+        /** @brief  Changes the period like the tasks do it themselves */
+        void changePeriod(uint16_t f_period) { setNewPeriod(f_period); }
+        /** @brief  Requests a run like an interrupt */
+        void request() { notify(); }
+
+        /** @brief  Simulated times of the runs in milliseconds */
+        std::vector<uint32_t> m_runs;
+        /** @brief  Simulated duration of the next runs */
+        std::chrono::milliseconds m_runTime;
+    private:
+        virtual void _run()
+        {
+            m_runs.push_back((uint32_t)(stub::timeUs() / 1000));
+            stub::advance(m_runTime);
+        }
+};
+
+/** @brief  Applies the manager until the simulated time */
+static void runUntil(utils::CTaskManager& f_manager, uint32_t f_time)
+{
+    while(stub::timeUs() / 1000 < f_time) f_manager.mainCallback();
+}
+
+/** @brief  Each task is applied exactly at the multiples of its period, the earliest deadline first */
+static void testHeapOrder()
+{
+    stub::timeUs() = 0;
+    const uint16_t l_periods[] = {7, 1, 13, 5, 2, 11, 3, 20, 17, 4, 9, 6};
+    const uint8_t l_count = sizeof(l_periods) / sizeof(l_periods[0]);
+    std::vector<CTestTask*> l_tasks;
+    utils::CTask* l_list[l_count];
+    for(uint8_t i = 0; i < l_count; i++)
+    {
+        l_tasks.push_back(new CTestTask(std::chrono::milliseconds(l_periods[i])));
+        l_list[i] = l_tasks[i];
+    }
+
+    utils::CTaskManager l_manager(l_list, l_count, std::chrono::milliseconds(1));
+    CHECK_EQUAL(l_count, l_manager.getTaskCount());
+    runUntil(l_manager, 1000);
+
+    for(uint8_t i = 0; i < l_count; i++)
+    {
+        const std::vector<uint32_t>& l_runs = l_tasks[i]->m_runs;
+        CHECK_EQUAL(999u / l_periods[i], (uint32_t)l_runs.size());
+        for(uint32_t k = 0; k < l_runs.size(); k++)
+        {
+            CHECK_EQUAL((k + 1) * l_periods[i], l_runs[k]);
+        }
+        CHECK_EQUAL(0u, l_tasks[i]->getStats().missed);
+        delete l_tasks[i];
+    }
+}
+
+/** @brief  The new period is counted from the change, the other tasks keep their deadlines */
+static void testReschedule()
+{
+    stub::timeUs() = 0;
+    CTestTask l_slow(std::chrono::milliseconds(50));
+    CTestTask l_other(std::chrono::milliseconds(10));
+    utils::CTask* l_list[] = {&l_slow, &l_other};
+    utils::CTaskManager l_manager(l_list, 2, std::chrono::milliseconds(1));
+
+    // The manager sleeps until the next deadline of the other task
+    runUntil(l_manager, 12);
+    uint32_t l_change = (uint32_t)(stub::timeUs() / 1000);
+    CHECK_EQUAL(20u, l_change);
+    l_slow.changePeriod(5);
+    runUntil(l_manager, l_change + 11);
+
+    CHECK_EQUAL(2u, (uint32_t)l_slow.m_runs.size());
+    CHECK_EQUAL(l_change + 5, l_slow.m_runs[0]);
+    CHECK_EQUAL(l_change + 10, l_slow.m_runs[1]);
+    CHECK_EQUAL(3u, (uint32_t)l_other.m_runs.size());
+    CHECK_EQUAL(30u, l_other.m_runs[2]);
+}
+
+/** @brief  The task without period runs only after notifications, the repeated ones are merged */
+static void testNotified()
+{
+    stub::timeUs() = 0;
+    CTestTask l_periodic(std::chrono::milliseconds(10));
+    CTestTask l_event(std::chrono::milliseconds(0));
+    utils::CTask* l_list[] = {&l_periodic, &l_event};
+    utils::CTaskManager l_manager(l_list, 2, std::chrono::milliseconds(1));
+
+    runUntil(l_manager, 25);
+    CHECK(l_event.m_runs.empty());
+
+    l_event.request();
+    l_event.request();
+    l_manager.mainCallback();
+    CHECK_EQUAL(1u, (uint32_t)l_event.m_runs.size());
+    CHECK_EQUAL(30u, l_event.m_runs[0]);
+
+    runUntil(l_manager, 60);
+    CHECK_EQUAL(1u, (uint32_t)l_event.m_runs.size());
+    CHECK_EQUAL(5u, (uint32_t)l_periodic.m_runs.size());
+}
+
+/** @brief  Number of the deadline callbacks */
+static uint32_t s_alerts = 0;
+static uint32_t s_hardMisses = 0;
+
+static void onDeadline(utils::CTask& /* f_task */, bool f_hard)
+{
+    if(f_hard) s_hardMisses++;
+    else s_alerts++;
+}
+
+/** @brief  The skipped activations are counted, a stall is reported once as hard miss */
+static void testOverrun()
+{
+    stub::timeUs() = 0;
+    s_alerts = 0;
+    s_hardMisses = 0;
+    CTestTask l_task(std::chrono::milliseconds(10));
+    l_task.setOverrunPolicy(utils::CTask::ALERT);
+    l_task.setHardDeadline(std::chrono::milliseconds(5));
+    utils::CTask* l_list[] = {&l_task};
+    utils::CTaskManager l_manager(l_list, 1, std::chrono::milliseconds(1));
+    l_manager.attachDeadlineCallback(mbed::callback(onDeadline));
+
+    // Three slow runs in a row: one stall
+    l_task.m_runTime = std::chrono::milliseconds(25);
+    runUntil(l_manager, 70);
+    CHECK_EQUAL(3u, (uint32_t)l_task.m_runs.size());
+    CHECK_EQUAL(1u, l_task.getStats().hardMisses);
+    CHECK_EQUAL(1u, s_hardMisses);
+    CHECK(l_task.getStats().missed > 0);
+    CHECK(s_alerts > 0);
+
+    // The task meets its deadline, then a new stall is reported again
+    l_task.m_runTime = std::chrono::milliseconds(0);
+    runUntil(l_manager, 100);
+    CHECK_EQUAL(1u, l_task.getStats().hardMisses);
+    l_task.m_runTime = std::chrono::milliseconds(8);
+    runUntil(l_manager, 111);
+    CHECK_EQUAL(2u, l_task.getStats().hardMisses);
+    CHECK_EQUAL(2u, s_hardMisses);
+}
+
+int main()
+{
+    RUN_TEST(testHeapOrder);
+    RUN_TEST(testReschedule);
+    RUN_TEST(testNotified);
+    RUN_TEST(testOverrun);
+    return TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <unittest.hpp>
+#include <utils/textformatter.hpp>
+
+#define _32_chars 32
+
+/** @brief  Integers, the limits of the 32-bit types and the leading zeros */
+static void testIntegers()
+{
+    char l_buffer[_32_chars];
+    utils::CTextFormatter l_text(l_buffer, sizeof(l_buffer));
+
+    l_text.appendSigned(INT32_MIN).appendChar(';').appendSigned(INT32_MAX).appendChar(';').appendSigned(0);
+    CHECK_EQUAL(0, strcmp(l_buffer, "-2147483648;2147483647;0"));
+    CHECK_EQUAL(strlen(l_buffer), l_text.length());
+
+    l_text.clear();
+    l_text.appendUnsigned(UINT32_MAX).appendChar(';').appendUnsigned(7, 3).appendChar(';').appendUnsigned(1234, 2);
+    CHECK_EQUAL(0, strcmp(l_buffer, "4294967295;007;1234"));
+}
+
+/** @brief  Fixed-point values, the sign of the values between -1 and 0 and the lowest value */
+static void testFixed()
+{
+    char l_buffer[_32_chars];
+    utils::CTextFormatter l_text(l_buffer, sizeof(l_buffer));
+
+    l_text.appendFixed(-1250, 3).appendChar(';').appendFixed(-5, 3).appendChar(';').appendFixed(0, 2).appendChar(';').appendFixed(42, 0);
+    CHECK_EQUAL(0, strcmp(l_buffer, "-1.250;-0.005;0.00;42"));
+
+    l_text.clear();
+    l_text.appendFixed(INT32_MIN, 3).appendChar(';').appendFixed(INT32_MIN, 9);
+    CHECK_EQUAL(0, strcmp(l_buffer, "-2147483.648;-2.147483648"));
+
+    l_text.clear();
+    l_text.appendFixed(INT32_MAX, 2);
+    CHECK_EQUAL(0, strcmp(l_buffer, "21474836.47"));
+}
+
+/** @brief  The fixed-point values give the same text as printf of the scaled value */
+static void testFixedAgainstPrintf()
+{
+    char l_buffer[_32_chars];
+    char l_expected[_32_chars];
+    const int32_t l_values[] = {0, 1, -1, 9, -9, 10, -10, 999, -999, 1000, -1000, 123456, -123456, INT32_MAX, INT32_MIN + 1};
+
+    for(uint8_t l_decimals = 0; l_decimals <= 3; l_decimals++)
+    {
+        int32_t l_scale = 1;
+        for(uint8_t i = 0; i < l_decimals; i++) l_scale *= 10;
+        for(uint32_t i = 0; i < sizeof(l_values) / sizeof(l_values[0]); i++)
+        {
+            int32_t l_value = l_values[i];
+            int32_t l_fraction = (l_value < 0) ? -(l_value % l_scale) : l_value % l_scale;
+            int32_t l_integer = (l_value < 0) ? -(l_value / l_scale) : l_value / l_scale;
+            if(0 == l_decimals) snprintf(l_expected, sizeof(l_expected), "%s%d", (l_value < 0) ? "-" : "", (int)l_integer);
+            else snprintf(l_expected, sizeof(l_expected), "%s%d.%0*d", (l_value < 0) ? "-" : "", (int)l_integer, (int)l_decimals, (int)l_fraction);
+
+            utils::CTextFormatter l_text(l_buffer, sizeof(l_buffer));
+            l_text.appendFixed(l_value, l_decimals);
+            CHECK_EQUAL(0, strcmp(l_expected, l_buffer));
+        }
+    }
+}
+
+/** @brief  The text is truncated to the buffer and kept null-terminated */
+static void testTruncation()
+{
+    char l_buffer[8];
+    utils::CTextFormatter l_text(l_buffer, sizeof(l_buffer));
+    l_text.append("@speed:").appendSigned(-1234).append(";;");
+    CHECK_EQUAL(0, strcmp(l_buffer, "@speed:"));
+    CHECK_EQUAL(7u, l_text.length());
+    CHECK(l_text.isFull());
+
+    l_text.clear();
+    CHECK(!l_text.isFull());
+    CHECK_EQUAL(0u, l_text.length());
+    CHECK_EQUAL(0, strcmp(l_buffer, ""));
+
+    // The buffer without space isn't written
+    char l_guard = 'x';
+    utils::CTextFormatter l_empty(&l_guard, 0);
+    l_empty.append("text").appendSigned(INT32_MIN);
+    CHECK_EQUAL('x', l_guard);
+    CHECK_EQUAL(0u, l_empty.length());
+    CHECK(l_empty.isFull());
+}
+
+int main()
+{
+    RUN_TEST(testIntegers);
+    RUN_TEST(testFixed);
+    RUN_TEST(testFixedAgainstPrintf);
+    RUN_TEST(testTruncation);
+    return TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) 2019, Bosch Engineering Center Cluj and BFMC organizers
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+
+#include <unittest.hpp>
+#include <utils/textparser.hpp>
+
+/** @brief  Checks the next field is the text */
+static bool isField(utils::CTextParser& f_parser, const char* f_text)
+{
+    const char* l_field;
+    uint32_t l_length;
+    return f_parser.nextField(l_field, l_length) && (strlen(f_text) == l_length) && (strncmp(f_text, l_field, l_length) == 0);
+}
+
+/** @brief  Fields, the empty ones, the spaces around them and the end of the text */
+static void testFields()
+{
+    utils::CTextParser l_parser(" a ;b c;;");
+    CHECK(!l_parser.atEnd());
+    CHECK(isField(l_parser, "a"));
+    CHECK(isField(l_parser, "b c"));
+    CHECK(isField(l_parser, ""));
+    CHECK(isField(l_parser, ""));     // after the last separator
+    CHECK(l_parser.atEnd());
+    CHECK(!isField(l_parser, ""));
+
+    // The empty text has one empty field
+    utils::CTextParser l_empty("");
+    CHECK(isField(l_empty, ""));
+    CHECK(!isField(l_empty, ""));
+
+    // Other separator, span without null-termination
+    const char l_span[] = {'1', ',', '2', ';', '3'};
+    utils::CTextParser l_comma(l_span, 3, ',');
+    uint32_t l_value = 0;
+    CHECK(l_comma.next(l_value));
+    CHECK_EQUAL(1u, l_value);
+    CHECK(l_comma.next(l_value));
+    CHECK_EQUAL(2u, l_value);
+    CHECK(!l_comma.next(l_value));
+}
+
+/** @brief  The limits of the 32-bit integers are accepted, the values over them are rejected */
+static void testOverflow()
+{
+    uint32_t l_unsigned = 7;
+    utils::CTextParser l_unsignedParser("4294967295;4294967296;99999999999;+0");
+    CHECK(l_unsignedParser.next(l_unsigned));
+    CHECK_EQUAL(UINT32_MAX, l_unsigned);
+    CHECK(!l_unsignedParser.next(l_unsigned));
+    CHECK(!l_unsignedParser.next(l_unsigned));
+    CHECK_EQUAL(UINT32_MAX, l_unsigned);      // unchanged by the rejected fields
+    CHECK(l_unsignedParser.next(l_unsigned));
+    CHECK_EQUAL(0u, l_unsigned);
+
+    int32_t l_signed = 7;
+    utils::CTextParser l_signedParser("2147483647;-2147483648;2147483648;-2147483649;-0");
+    CHECK(l_signedParser.next(l_signed));
+    CHECK_EQUAL(INT32_MAX, l_signed);
+    CHECK(l_signedParser.next(l_signed));
+    CHECK_EQUAL(INT32_MIN, l_signed);
+    CHECK(!l_signedParser.next(l_signed));
+    CHECK(!l_signedParser.next(l_signed));
+    CHECK(l_signedParser.next(l_signed));
+    CHECK_EQUAL(0, l_signed);
+}
+
+/** @brief  The fields are checked completely and against the range */
+static void testInvalid()
+{
+    int32_t l_value = 7;
+    utils::CTextParser l_parser("12a;;-;+;1 2;0x10;501;-501; 500 ");
+    for(uint8_t i = 0; i < 8; i++)
+    {
+        CHECK(!l_parser.next(l_value, -500, 500));
+    }
+    CHECK_EQUAL(7, l_value);
+    CHECK(l_parser.next(l_value, -500, 500));
+    CHECK_EQUAL(500, l_value);
+
+    // A negative value isn't an unsigned one
+    uint32_t l_unsigned;
+    utils::CTextParser l_negative("-1");
+    CHECK(!l_negative.next(l_unsigned));
+}
+
+/** @brief  Fixed-point fields */
+static void testFixed()
+{
+    int32_t l_value = 0;
+    utils::CTextParser l_parser("-1.25;1.239;.5;5.;3;-.75");
+    CHECK(l_parser.nextFixed(l_value, 2));
+    CHECK_EQUAL(-125, l_value);
+    CHECK(l_parser.nextFixed(l_value, 2));
+    CHECK_EQUAL(123, l_value);                // the further digits are truncated
+    CHECK(l_parser.nextFixed(l_value, 2));
+    CHECK_EQUAL(50, l_value);
+    CHECK(l_parser.nextFixed(l_value, 2));
+    CHECK_EQUAL(500, l_value);
+    CHECK(l_parser.nextFixed(l_value, 0));
+    CHECK_EQUAL(3, l_value);
+    CHECK(l_parser.nextFixed(l_value, 2));
+    CHECK_EQUAL(-75, l_value);
+
+    l_value = 7;
+    utils::CTextParser l_invalid(".;-;1.2.3;1e3;21474836.48;42949672.96;1.5");
+    for(uint8_t i = 0; i < 6; i++)
+    {
+        CHECK(!l_invalid.nextFixed(l_value, 2));
+    }
+    CHECK_EQUAL(7, l_value);
+    CHECK(!l_invalid.nextFixed(l_value, 1, -10, 10));   // 15 is out of the range in the fixed-point scale
+
+    // The lowest value fits only as a negative one
+    utils::CTextParser l_lowest("-21474836.48");
+    CHECK(l_lowest.nextFixed(l_value, 2));
+    CHECK_EQUAL(INT32_MIN, l_value);
+}
+
+/** @brief  The range of the smaller types is checked */
+static void testNextAs()
+{
+    uint8_t l_byte = 7;
+    utils::CTextParser l_unsigned("255;256");
+    CHECK(l_unsigned.nextAs<uint8_t>(l_byte, 0, UINT8_MAX));
+    CHECK_EQUAL(255, l_byte);
+    CHECK(!l_unsigned.nextAs<uint8_t>(l_byte, 0, UINT8_MAX));
+    CHECK_EQUAL(255, l_byte);
+
+    int8_t l_char = 7;
+    utils::CTextParser l_signed("-128;-129");
+    CHECK(l_signed.nextAs<int8_t>(l_char, INT8_MIN, INT8_MAX));
+    CHECK_EQUAL(-128, l_char);
+    CHECK(!l_signed.nextAs<int8_t>(l_char, INT8_MIN, INT8_MAX));
+}
+
+int main()
+{
+    RUN_TEST(testFields);
+    RUN_TEST(testOverflow);
+    RUN_TEST(testInvalid);
+    RUN_TEST(testFixed);
+    RUN_TEST(testNextAs);
+    return TEST_RESULT();
+}
\ No newline at end of file